@@ -0,0 +1,502 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "bench.hpp"
+#include "canvas.hpp"
+#include "display.hpp"
+#include "pixel.hpp"
+#include "shm_arena.hpp"
+#include "shm_pool.hpp"
+#include "swapchain.hpp"
+#include "tile_renderer.hpp"
+#include "window.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace sandbox::wayland::bench
+{
+
+namespace
+{
+
+namespace pixel = fubuki::io::platform::linux_bsd::wayland::pixel;
+namespace fbk_wl = fubuki::io::platform::linux_bsd::wayland;
+
+using clock = std::chrono::steady_clock;
+
+constexpr std::uint8_t alpha = 0x80;
+
+/// The implementation of apply_opacity before the pixel kernels.
+void reference_opacity(std::span<std::byte> memory, std::uint8_t alpha)
+{
+    std::ranges::fill(memory | std::views::enumerate
+                          | std::views::filter(
+                              [](const auto& t) noexcept
+                              {
+                                  const auto& [index, byte] = t;
+                                  std::ignore               = byte;
+                                  return (index % 4 == 3);
+                              })
+                          | std::views::values,
+                      static_cast<std::byte>(alpha));
+}
+
+/// Returns the throughput of f in GB/s.
+template<typename func>
+[[nodiscard]] double throughput(std::span<std::byte> memory, std::size_t iterations, func&& f)
+{
+    f(memory); // Warm-up, also faults every page in
+
+    const auto start = clock::now();
+
+    for(std::size_t i = 0; i < iterations; ++i)
+    {
+        f(memory);
+    }
+
+    const std::chrono::duration<double> elapsed = clock::now() - start;
+
+    return static_cast<double>(memory.size_bytes() * iterations) / elapsed.count() / 1e9;
+}
+
+void report(std::string_view label, double gbps)
+{
+    std::cout << std::left << std::setw(32) << label << std::right << std::fixed << std::setprecision(2) << std::setw(10) << gbps << " GB/s\n";
+}
+
+/// Returns the number of page faults so far, minor and major, of the process or of the calling thread only.
+[[nodiscard]] long page_faults(int who = RUSAGE_SELF) noexcept
+{
+    rusage usage = {};
+    getrusage(who, &usage);
+
+    return usage.ru_minflt + usage.ru_majflt;
+}
+
+[[nodiscard]] double milliseconds(clock::duration d) noexcept { return std::chrono::duration<double, std::milli>(d).count(); }
+
+} // namespace
+
+[[nodiscard]] int opacity()
+{
+    constexpr std::size_t width  = 3840;
+    constexpr std::size_t height = 2160;
+    constexpr std::size_t stride = 4;
+
+    constexpr std::size_t reference_iterations = 10;
+    constexpr std::size_t kernel_iterations    = 200;
+
+    std::vector<std::byte> memory(width * height * stride, std::byte{0x7F});
+
+    std::cout << "opacity kernels, " << width << "x" << height << " ARGB8888, detected isa: " << pixel::detected_isa() << "\n";
+
+    report("reference (ranges)", throughput(memory, reference_iterations, [](auto m) { reference_opacity(m, alpha); }));
+
+    for(const auto target : {pixel::isa::scalar, pixel::isa::sse2, pixel::isa::avx2, pixel::isa::avx512})
+    {
+        if(target > pixel::detected_isa())
+        {
+            break;
+        }
+
+        std::ostringstream set_alpha_label   = {};
+        std::ostringstream premultiply_label = {};
+
+        set_alpha_label << "set_alpha (" << target << ")";
+        premultiply_label << "premultiply (" << target << ")";
+
+        report(set_alpha_label.view(), throughput(memory, kernel_iterations, [target](auto m) { pixel::set_alpha(m, alpha, target); }));
+        report(premultiply_label.view(), throughput(memory, kernel_iterations, [target](auto m) { pixel::premultiply(m, alpha, target); }));
+    }
+
+    // Keeps the buffer observable so that the writes are not optimised away
+    std::cout << "checksum: " << std::to_integer<int>(memory[3]) << "\n" << std::flush;
+
+    return 0;
+}
+
+[[nodiscard]] int clear()
+{
+    constexpr std::size_t width  = 3840;
+    constexpr std::size_t height = 2160;
+    constexpr std::size_t stride = 4;
+
+    constexpr std::size_t iterations = 100;
+
+    // Translucent black, what a window with an opacity of 0.5 draws
+    constexpr std::uint32_t colour = std::uint32_t{alpha} << 24U;
+
+    std::vector<std::byte> memory(width * height * stride, std::byte{0x7F});
+
+    std::cout << "clear kernels, " << width << "x" << height << " ARGB8888 (" << (memory.size() >> 20U)
+              << " MiB), streaming threshold: " << (pixel::streaming_threshold() >> 20U) << " MiB\n";
+
+    report("clear, then set_alpha",
+           throughput(memory,
+                      iterations,
+                      [](auto m)
+                      {
+                          std::ranges::fill(m, std::byte{0x00});
+                          pixel::set_alpha(m, alpha);
+                      }));
+
+    for(const auto target : {pixel::isa::scalar, pixel::isa::sse2, pixel::isa::avx2, pixel::isa::avx512})
+    {
+        if(target > pixel::detected_isa())
+        {
+            break;
+        }
+
+        for(const auto s : {pixel::store::temporal, pixel::store::non_temporal})
+        {
+            std::ostringstream label = {};
+            label << "fill (" << target << ", " << s << ")";
+
+            report(label.view(), throughput(memory, iterations, [=](auto m) { pixel::fill(m, colour, target, s); }));
+        }
+    }
+
+    for(const std::size_t threads : {2U, 4U, 8U})
+    {
+        std::ostringstream label = {};
+        label << "fill_striped (" << threads << " threads)";
+
+        report(label.view(), throughput(memory, iterations, [=](auto m) { pixel::fill_striped(m, colour, threads); }));
+    }
+
+    std::cout << "checksum: " << std::to_integer<int>(memory[3]) << "\n" << std::flush;
+
+    return 0;
+}
+
+[[nodiscard]] int canvas()
+{
+    constexpr std::size_t width  = 3840;
+    constexpr std::size_t height = 2160;
+    constexpr std::size_t stride = width * 4;
+
+    constexpr std::size_t iterations      = 50;
+    constexpr std::size_t line_iterations = 20;
+
+    // Translucent grey, premultiplied
+    constexpr std::uint32_t colour = 0x80404040;
+
+    std::vector<std::byte> memory(stride * height, std::byte{0x7F});
+    std::vector<std::byte> image(stride * height, std::byte{0x40});
+
+    fbk_wl::canvas target{memory, width, height, stride};
+
+    const fbk_wl::canvas source{image, width, height, stride};
+    const auto           all = target.bounds();
+
+    std::cout << "canvas primitives, " << width << "x" << height << " ARGB8888, detected isa: " << pixel::detected_isa() << "\n";
+
+    report("clear", throughput(memory, iterations, [&](auto) { std::ignore = target.clear(colour); }));
+    report("fill_rect", throughput(memory, iterations, [&](auto) { std::ignore = target.fill_rect(all, colour); }));
+    report("blend_rect", throughput(memory, iterations, [&](auto) { std::ignore = target.blend_rect(all, colour); }));
+    report("blit", throughput(memory, iterations, [&](auto) { std::ignore = target.blit(source.view(), {0, 0}); }));
+    report("blit (self, overlapping)", throughput(memory, iterations, [&](auto) { std::ignore = target.blit(target.view(), {1, 1}); }));
+    report("blend", throughput(memory, iterations, [&](auto) { std::ignore = target.blend(source.view(), {0, 0}); }));
+
+    for(const auto isa : {pixel::isa::scalar, pixel::isa::sse2, pixel::isa::avx2, pixel::isa::avx512})
+    {
+        if(isa > pixel::detected_isa())
+        {
+            break;
+        }
+
+        std::ostringstream label = {};
+        label << "blend kernel (" << isa << ")";
+
+        report(label.view(), throughput(memory, iterations, [&](auto m) { pixel::blend(m, image, isa); }));
+    }
+
+    // Strokes and lines touch few pixels: reported as the throughput of the whole canvas they are drawn over, per call
+    report("stroke_rect (16 px)", throughput(memory, iterations, [&](auto) { std::ignore = target.stroke_rect(all, colour, 16); }));
+
+    report("line (diagonals)",
+           throughput(memory,
+                      line_iterations,
+                      [&](auto)
+                      {
+                          for(std::int32_t x = 0; x < all.extent.width; x += 64)
+                          {
+                              std::ignore = target.line({x, 0}, {all.extent.width - 1 - x, all.extent.height - 1}, colour);
+                          }
+                      }));
+
+    std::cout << "checksum: " << std::to_integer<int>(memory[3]) << "\n" << std::flush;
+
+    return 0;
+}
+
+[[nodiscard]] int tiles()
+{
+    constexpr std::size_t iterations = 20;
+
+    // Translucent black, as a window with an opacity of 0.5, with translucent panels over it
+    constexpr std::uint32_t background = std::uint32_t{alpha} << 24U;
+    constexpr std::uint32_t panel      = 0x40202020;
+    constexpr std::int32_t  step       = 96;
+
+    const auto draw = [](fbk_wl::canvas& tile, fubuki::rectangle2d area)
+    {
+        std::ignore = tile.clear(background);
+
+        // Panels in canvas coordinates, translated to the tile. Each primitive clips to the tile
+        for(std::int32_t y = -(area.offset.y % step); y < area.extent.height; y += step)
+        {
+            std::ignore = tile.blend_rect({.offset = {-(area.offset.x % step), y}, .extent = {area.extent.width + step, step / 2}}, panel);
+        }
+    };
+
+    std::cout << "tile renderer, hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    for(const auto& [width, height] : {std::pair<std::size_t, std::size_t>{3840, 2160}, std::pair<std::size_t, std::size_t>{7680, 4320}})
+    {
+        std::vector<std::byte> memory(width * height * 4, std::byte{0x7F});
+
+        fbk_wl::canvas target{memory, width, height, width * 4};
+
+        double single = 0.;
+
+        for(const std::size_t threads : {1U, 2U, 4U, 8U})
+        {
+            auto renderer = fbk_wl::tile_renderer::make({.threads = threads});
+
+            if(not renderer)
+            {
+                return 1;
+            }
+
+            const double gbps = throughput(memory, iterations, [&](auto) { renderer->render(target, draw); });
+
+            single = (threads == 1) ? gbps : single;
+
+            std::ostringstream label = {};
+            label << width << "x" << height << ", " << threads << " threads (" << std::fixed << std::setprecision(2) << gbps / single << "x)";
+
+            report(label.view(), gbps);
+        }
+
+        std::cout << "checksum: " << std::to_integer<int>(memory[3]) << "\n";
+    }
+
+    std::cout << std::flush;
+
+    return 0;
+}
+
+[[nodiscard]] int backing()
+{
+    using policy     = fbk_wl::shm_pool::backing_policy;
+    using pages      = policy::pages;
+    using allocation = fubuki::io::platform::linux_bsd::file_descriptor::allocation;
+
+    struct candidate
+    {
+        std::string_view label;
+        policy           backing;
+    };
+
+    const std::array candidates = {
+        candidate{"reserve", {}},
+        candidate{"sparse", {.allocation = allocation::sparse}},
+        candidate{"reserve, prefault", {.prefault = true}},
+        candidate{"sparse, prefault", {.allocation = allocation::sparse, .prefault = true}},
+        candidate{"thp", {.page_size = pages::transparent_huge}},
+        candidate{"thp, prefault", {.page_size = pages::transparent_huge, .prefault = true}},
+        candidate{"hugetlb", {.page_size = pages::huge}},
+        candidate{"hugetlb, prefault", {.page_size = pages::huge, .prefault = true}},
+    };
+
+    auto display = fbk_wl::display::make();
+
+    if(not display)
+    {
+        return 1;
+    }
+
+    constexpr std::size_t width  = 3840;
+    constexpr std::size_t height = 2160;
+
+    std::cout << "shm_pool backing, " << width << "x" << height << " ARGB8888, 2 layers\n"
+              << std::left << std::setw(24) << "policy" << std::right << std::setw(14) << "create (ms)" << std::setw(14) << "faults"
+              << std::setw(18) << "1st frame (ms)" << std::setw(14) << "faults" << "\n";
+
+    for(const auto& [label, backing] : candidates)
+    {
+        const auto faults_start = page_faults();
+        const auto start        = clock::now();
+
+        auto pool = fbk_wl::shm_pool::make(*display, {.width = width, .height = height, .layers = 2, .backing = backing});
+
+        if(not pool)
+        {
+            std::cerr << "Failed to create a pool with policy " << std::quoted(label) << "\n" << std::flush;
+            return 1;
+        }
+
+        const auto faults_created = page_faults();
+        const auto created        = clock::now();
+
+        // What the first frame of a window does: clear a layer, then set its alpha channel
+        const auto layer = pool->memory().first(width * height * 4);
+
+        std::ranges::fill(layer, std::byte{0x00});
+        pixel::set_alpha(layer, alpha);
+
+        const auto faults_drawn = page_faults();
+        const auto drawn        = clock::now();
+
+        std::cout << std::left << std::setw(24) << label << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+                  << milliseconds(created - start) << std::setw(14) << (faults_created - faults_start) << std::setw(18)
+                  << milliseconds(drawn - created) << std::setw(14) << (faults_drawn - faults_created)
+                  << (pool->info().backing != backing ? "  (fell back to thp)" : "") << "\n";
+    }
+
+    std::cout << std::flush;
+
+    return 0;
+}
+
+[[nodiscard]] int prefault()
+{
+    auto display = fbk_wl::display::make();
+
+    if(not display)
+    {
+        return 1;
+    }
+
+    constexpr std::size_t width  = 3840;
+    constexpr std::size_t height = 2160;
+
+    std::cout << "swapchain first frame, " << width << "x" << height << " ARGB8888, double buffering\n"
+              << std::left << std::setw(24) << "prefault" << std::right << std::setw(18) << "1st frame (ms)" << std::setw(18)
+              << "thread faults" << "\n";
+
+    for(const bool background : {false, true})
+    {
+        // A new arena for each run, so that no page was faulted in already
+        fbk_wl::shm_arena arena{display->globals()};
+
+        const auto faults_start = page_faults(RUSAGE_THREAD);
+        const auto start        = clock::now();
+
+        auto chain = fbk_wl::swapchain::make(arena, {.width = width, .height = height, .background_prefault = background});
+
+        if(not chain)
+        {
+            return 2;
+        }
+
+        display->roundtrip();
+
+        // What the configure callback of a window does before committing
+        const auto index = chain->acquire();
+
+        if(not index)
+        {
+            return 3;
+        }
+
+        auto& layer = (*chain)[*index];
+
+        std::ranges::fill(layer.memory(), std::byte{0x00});
+        pixel::set_alpha(layer.memory(), alpha);
+
+        const auto drawn        = clock::now();
+        const auto faults_drawn = page_faults(RUSAGE_THREAD);
+
+        std::cout << std::left << std::setw(24) << (background ? "background" : "none") << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(18) << milliseconds(drawn - start) << std::setw(18) << (faults_drawn - faults_start) << "\n";
+    }
+
+    std::cout << std::flush;
+
+    return 0;
+}
+
+[[nodiscard]] int startup()
+{
+    constexpr int runs = 5;
+
+    std::cout << "startup, 640x480 window\n"
+              << std::left << std::setw(8) << "run" << std::right << std::setw(18) << "display (ms)" << std::setw(18) << "window (ms)"
+              << std::setw(22) << "1st commit (ms)" << std::setw(10) << "outputs" << "\n";
+
+    for(int run = 0; run < runs; ++run)
+    {
+        const auto start = clock::now();
+
+        auto display = fbk_wl::display::make();
+
+        if(not display)
+        {
+            return 1;
+        }
+
+        const auto connected = clock::now();
+
+        // Returns once the initial configure event was handled, which draws and commits the first frame
+        auto window = fbk_wl::window::make(*display, {.title = "startup", .size = {640, 480}});
+
+        if(not window)
+        {
+            return 2;
+        }
+
+        const auto committed = clock::now();
+
+        std::cout << std::left << std::setw(8) << run << std::right << std::fixed << std::setprecision(2) << std::setw(18)
+                  << milliseconds(connected - start) << std::setw(18) << milliseconds(committed - connected) << std::setw(22)
+                  << milliseconds(committed - start) << std::setw(10) << display->outputs().size() << "\n";
+    }
+
+    std::cout << std::flush;
+
+    return 0;
+}
+
+} // namespace sandbox::wayland::bench
@@ -0,0 +1,62 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WAYLAND_SANDBOX_BENCH_HPP
+#define WAYLAND_SANDBOX_BENCH_HPP
+
+namespace sandbox::wayland::bench
+{
+
+/// Measures the throughput of the pixel::set_alpha and pixel::premultiply kernels for each supported instruction set on a 4K buffer,
+/// against the std::ranges implementation window.cpp used before.
+[[nodiscard]] int opacity();
+
+/// Measures the throughput of pixel::fill with regular and non-temporal stores, and of pixel::fill_striped, against a clear followed by
+/// pixel::set_alpha, on a 4K buffer.
+[[nodiscard]] int clear();
+
+/// Measures the throughput of each canvas primitive on a 4K canvas, and of the pixel::blend kernel for each supported instruction set.
+[[nodiscard]] int canvas();
+
+/// Measures the throughput of tile_renderer on 4K and 8K canvases, for several thread counts, and the speedup over a single thread.
+[[nodiscard]] int tiles();
+
+/// Measures page faults and latencies of the creation and the first frame of a 4K double-buffered shm_pool, for each backing policy.
+[[nodiscard]] int backing();
+
+/// Measures the time from the creation of a 4K swapchain to its first frame, with and without background prefaulting.
+/// A roundtrip runs in between, as in window::create.
+[[nodiscard]] int prefault();
+
+/// Measures the time from display::make to the first commit of a window, which happens once window::make returns. Outputs are
+/// enumerated by display::make, in the same registry pass as the other globals.
+[[nodiscard]] int startup();
+
+} // namespace sandbox::wayland::bench
+
+#endif // WAYLAND_SANDBOX_BENCH_HPP
@@ -0,0 +1,393 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "display.hpp"
+#include "file_descriptor.hpp"
+#include "pixel.hpp"
+#include "screen.hpp"
+#include "shm_buffer.hpp"
+#include "shm_pool.hpp"
+#include "window.hpp"
+
+#if defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+    #include "mock/compositor.hpp"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sandbox::wayland::bench_suite
+{
+
+namespace
+{
+
+namespace pixel  = fubuki::io::platform::linux_bsd::wayland::pixel;
+namespace fbk_wl = fubuki::io::platform::linux_bsd::wayland;
+
+using clock = std::chrono::steady_clock;
+using fd    = fubuki::io::platform::linux_bsd::file_descriptor;
+
+constexpr std::size_t width  = 1920;
+constexpr std::size_t height = 1080;
+constexpr std::size_t stride = 4;
+
+constexpr std::uint8_t alpha = 0x80;
+
+/// Samples of a benchmark, in nanoseconds. Sorted once the benchmark completed.
+struct result
+{
+    std::string_view    name    = {};
+    std::vector<double> samples = {};
+    bool                failed  = false;
+
+    /// Returns a percentile of the samples, by nearest rank. p is in [0, 100].
+    [[nodiscard]] double percentile(double p) const noexcept
+    {
+        const auto rank = static_cast<std::size_t>(std::ceil(p / 100. * static_cast<double>(samples.size())));
+        return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+    }
+
+    [[nodiscard]] double mean() const noexcept
+    {
+        double sum = 0.;
+
+        for(const auto s : samples)
+        {
+            sum += s;
+        }
+
+        return sum / static_cast<double>(samples.size());
+    }
+};
+
+/**
+ * Runs a benchmark: a few warm-up runs, then one sample per iteration. Each run returns the duration of what it measures, so that setup
+ * and teardown stay out of the samples, or std::nullopt if it failed.
+ */
+template<typename func>
+[[nodiscard]] result measure(std::string_view name, std::size_t iterations, func&& f)
+{
+    constexpr std::size_t warm_up = 3;
+
+    result r{.name = name};
+    r.samples.reserve(iterations);
+
+    std::cerr << std::left << std::setw(56) << name << std::flush;
+
+    for(std::size_t i = 0; i < warm_up + iterations; ++i)
+    {
+        const std::optional<clock::duration> d = f();
+
+        if(not d)
+        {
+            std::cerr << "failed\n" << std::flush;
+            r.failed = true;
+            return r;
+        }
+
+        if(i >= warm_up)
+        {
+            r.samples.push_back(std::chrono::duration<double, std::nano>(*d).count());
+        }
+    }
+
+    std::ranges::sort(r.samples);
+
+    std::cerr << std::right << std::fixed << std::setprecision(0) << std::setw(12) << r.percentile(50) << " ns\n" << std::flush;
+
+    return r;
+}
+
+/**
+ * Times a call. The value it returns is destroyed after the clock stopped.
+ * @returns std::nullopt if the value converts to false, like an empty std::expected.
+ */
+template<typename func>
+[[nodiscard]] std::optional<clock::duration> timed(func&& f)
+{
+    const auto start   = clock::now();
+    const auto value   = f();
+    const auto elapsed = clock::now() - start;
+
+    if(not value)
+    {
+        return std::nullopt;
+    }
+
+    return elapsed;
+}
+
+void write_json(std::ostream& out, std::string_view compositor, const std::vector<result>& results)
+{
+    out << "{\n"
+        << "  \"compositor\": \"" << compositor << "\",\n"
+        << "  \"isa\": \"" << pixel::detected_isa() << "\",\n"
+        << "  \"unit\": \"ns\",\n"
+        << "  \"benchmarks\": [";
+
+    const char* separator = "\n";
+
+    for(const auto& r : results)
+    {
+        out << separator << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.samples.size()
+            << ", \"failed\": " << (r.failed ? "true" : "false");
+
+        if(not r.failed)
+        {
+            out << std::fixed << std::setprecision(1) << ", \"min\": " << r.samples.front() << ", \"p50\": " << r.percentile(50)
+                << ", \"p90\": " << r.percentile(90) << ", \"p95\": " << r.percentile(95) << ", \"p99\": " << r.percentile(99)
+                << ", \"max\": " << r.samples.back() << ", \"mean\": " << r.mean();
+        }
+
+        out << "}";
+        separator = ",\n";
+    }
+
+    out << "\n  ]\n}\n" << std::flush;
+}
+
+/// Runs every benchmark against a display.
+[[nodiscard]] std::vector<result> run(fbk_wl::display& display)
+{
+    constexpr std::size_t pool_size_bytes = width * height * stride * 2;
+
+    std::vector<result> results;
+
+    // Requests are flushed and their events handled between samples, outside of the measures
+    const auto settle = [&display] { display.roundtrip(); };
+
+    for(const auto& [name, alloc] : {std::pair{"file_descriptor::make_anonymous (memfd, reserve, 1080p x2)", fd::allocation::reserve},
+                                    std::pair{"file_descriptor::make_anonymous (memfd, sparse, 1080p x2)", fd::allocation::sparse}})
+    {
+        results.push_back(measure(name,
+                                  200,
+                                  [alloc]
+                                  {
+                                      return timed([alloc]
+                                                   { return fd::make_anonymous(pool_size_bytes, "/tmp/", "fubuki-bench", {}, alloc); });
+                                  }));
+    }
+
+    results.push_back(measure("shm_pool::make (1080p x2)",
+                              100,
+                              [&]
+                              {
+                                  auto d = timed([&] { return fbk_wl::shm_pool::make(display, {.width = width, .height = height}); });
+                                  settle();
+                                  return d;
+                              }));
+
+    if(auto pool = fbk_wl::shm_pool::make(display, {.width = width, .height = height}))
+    {
+        std::size_t index = 0;
+
+        results.push_back(measure("shm_buffer::make (1080p)",
+                                  1000,
+                                  [&]
+                                  {
+                                      auto d = timed([&] { return fbk_wl::shm_buffer::make(*pool, {.index = index++ % 2}); });
+                                      settle();
+                                      return d;
+                                  }));
+    }
+    else
+    {
+        results.push_back({.name = "shm_buffer::make (1080p)", .failed = true});
+    }
+
+    std::vector<std::byte> layer(width * height * stride, std::byte{0x7F});
+
+    const auto kernel = [&layer](auto f)
+    {
+        return [&layer, f]
+        {
+            return timed(
+                [&]
+                {
+                    f(std::span{layer});
+                    return true;
+                });
+        };
+    };
+
+    // What window opacity changes used to run, before the background became a premultiplied clear
+    results.push_back(measure("apply_opacity (pixel::set_alpha, 1080p)", 200, kernel([](auto m) { pixel::set_alpha(m, alpha); })));
+    results.push_back(measure("apply_opacity (pixel::premultiply, 1080p)", 200, kernel([](auto m) { pixel::premultiply(m, alpha); })));
+
+    constexpr std::uint32_t colour = 0x80000000;
+
+    results.push_back(measure("clear (pixel::fill, 1080p)", 200, kernel([](auto m) { pixel::fill(m, colour); })));
+    results.push_back(measure("clear (pixel::fill_striped, 1080p)", 200, kernel([](auto m) { pixel::fill_striped(m, colour); })));
+
+    // Includes the roundtrip to the initial configure event and the first frame
+    results.push_back(measure("window::make (640x480)",
+                              20,
+                              [&]
+                              {
+                                  auto d = timed([&] { return fbk_wl::window::make(display, {.title = "bench", .size = {640, 480}}); });
+                                  settle();
+                                  return d;
+                              }));
+
+    if(auto window = fbk_wl::window::make(display, {.title = "bench", .size = {640, 480}}))
+    {
+        constexpr std::array<fubuki::dimension2d, 2> sizes = {
+            fubuki::dimension2d{800, 600},
+            fubuki::dimension2d{640, 480},
+        };
+
+        std::size_t index = 0;
+
+        // Reallocates the swapchain, redraws and commits. Settling lets the compositor release the buffers
+        results.push_back(measure("window::resize (640x480 <-> 800x600)",
+                                  100,
+                                  [&]
+                                  {
+                                      auto d = timed(
+                                          [&]
+                                          {
+                                              window->resize(sizes.at(index++ % sizes.size()));
+                                              return true;
+                                          });
+                                      settle();
+                                      return d;
+                                  }));
+    }
+    else
+    {
+        results.push_back({.name = "window::resize (640x480 <-> 800x600)", .failed = true});
+    }
+
+    results.push_back(measure("screen::enumerate",
+                              1000,
+                              [&] { return timed([&] { return std::optional{fbk_wl::screen::enumerate(display)}; }); }));
+
+    return results;
+}
+
+} // namespace
+
+} // namespace sandbox::wayland::bench_suite
+
+/**
+ * Usage: wayland-sandbox-bench [--live] [--output <file>]
+ * Runs against the mock compositor when it is built, unless --live is given, and against the compositor of the session otherwise.
+ * Writes the results as JSON to the standard output, or to a file. Progress is written to the standard error.
+ */
+int main(int argc, char** argv)
+{
+    namespace suite  = sandbox::wayland::bench_suite;
+    namespace fbk_wl = fubuki::io::platform::linux_bsd::wayland;
+
+    const std::span<char*> args{argv, static_cast<std::size_t>(argc)};
+
+    bool        live   = false;
+    const char* output = nullptr;
+
+    for(std::size_t i = 1; i < args.size(); ++i)
+    {
+        const std::string_view arg = args[i];
+
+        if(arg == "--live")
+        {
+            live = true;
+        }
+        else if(arg == "--output" and i + 1 < args.size())
+        {
+            output = args[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << args[0] << " [--live] [--output <file>]\n" << std::flush;
+            return 1;
+        }
+    }
+
+    const char* socket = nullptr;
+
+#if defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
+    std::optional<fbk_wl::mock::compositor> compositor = {};
+
+    if(not live)
+    {
+        // Frame events answer commits at once: the window benchmarks do not wait for a refresh
+        auto c = fbk_wl::mock::compositor::make({.frame_interval = {}});
+
+        if(not c)
+        {
+            std::cerr << "Failed to start the mock compositor\n" << std::flush;
+            return 2;
+        }
+
+        compositor.emplace(*std::move(c));
+        socket = compositor->socket_name();
+    }
+
+#else
+
+    live = true;
+
+#endif // defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
+    auto display = fbk_wl::display::make(socket);
+
+    if(not display)
+    {
+        std::cerr << "Failed to connect to the compositor\n" << std::flush;
+        return 2;
+    }
+
+    const auto results = suite::run(*display);
+
+    if(output != nullptr)
+    {
+        std::ofstream file{output};
+        suite::write_json(file, live ? "live" : "mock", results);
+    }
+    else
+    {
+        suite::write_json(std::cout, live ? "live" : "mock", results);
+    }
+
+    return std::ranges::any_of(results, &suite::result::failed) ? 3 : 0;
+}
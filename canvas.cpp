@@ -0,0 +1,278 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "canvas.hpp"
+#include "pixel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+constexpr std::size_t pixel_size = 4;
+
+[[nodiscard]] constexpr std::int32_t right(const rectangle2d& r) noexcept { return r.offset.x + r.extent.width; }
+[[nodiscard]] constexpr std::int32_t bottom(const rectangle2d& r) noexcept { return r.offset.y + r.extent.height; }
+
+[[nodiscard]] constexpr bool is_empty(const rectangle2d& r) noexcept { return r.extent.width <= 0 or r.extent.height <= 0; }
+
+/// Returns the intersection of two rectangles, or an empty rectangle if they do not overlap.
+[[nodiscard]] constexpr rectangle2d intersection(const rectangle2d& a, const rectangle2d& b) noexcept
+{
+    const std::int32_t l = std::max(a.offset.x, b.offset.x);
+    const std::int32_t t = std::max(a.offset.y, b.offset.y);
+    const std::int32_t r = std::min(right(a), right(b));
+    const std::int32_t d = std::min(bottom(a), bottom(b));
+
+    if(r <= l or d <= t)
+    {
+        return {};
+    }
+
+    return {.offset = {l, t}, .extent = {r - l, d - t}};
+}
+
+[[nodiscard]] constexpr rectangle2d extent_of(std::size_t width, std::size_t height) noexcept
+{
+    return {.offset = {0, 0}, .extent = {static_cast<std::int32_t>(width), static_cast<std::int32_t>(height)}};
+}
+
+/// Returns the pixels of r in row y of an image.
+[[nodiscard]] std::span<const std::byte> image_row(const image_view& image, const rectangle2d& r, std::int32_t y) noexcept
+{
+    const auto offset = static_cast<std::size_t>(y) * image.stride + static_cast<std::size_t>(r.offset.x) * pixel_size;
+
+    return image.memory.subspan(offset, static_cast<std::size_t>(r.extent.width) * pixel_size);
+}
+
+} // namespace
+
+[[nodiscard]] image_view view(const shm_buffer& buffer) noexcept
+{
+    assert(bytes_per_pixel(buffer.format()) == pixel_size);
+
+    return {.memory = buffer.memory(), .width = buffer.width(), .height = buffer.height(), .stride = buffer.stride()};
+}
+
+canvas::canvas(std::span<std::byte> memory, std::size_t width, std::size_t height, std::size_t stride) noexcept :
+      m_memory{memory}, m_width{width}, m_height{height}, m_stride{stride}
+{
+    assert(m_stride >= m_width * pixel_size);
+    assert(m_height == 0 or m_memory.size() >= (m_height - 1) * m_stride + m_width * pixel_size);
+}
+
+canvas::canvas(shm_buffer& buffer) noexcept : canvas{buffer.memory(), buffer.width(), buffer.height(), buffer.stride()}
+{
+    assert(bytes_per_pixel(buffer.format()) == pixel_size);
+}
+
+[[nodiscard]] rectangle2d canvas::bounds() const noexcept { return extent_of(m_width, m_height); }
+
+[[nodiscard]] std::span<std::byte> canvas::row(const rectangle2d& r, std::int32_t y) noexcept
+{
+    const auto offset = static_cast<std::size_t>(y) * m_stride + static_cast<std::size_t>(r.offset.x) * pixel_size;
+
+    return m_memory.subspan(offset, static_cast<std::size_t>(r.extent.width) * pixel_size);
+}
+
+rectangle2d canvas::clear(std::uint32_t colour) noexcept
+{
+    // Tightly packed rows form a single span, which lets pixel::fill stream large canvases past the cache
+    if(m_stride == m_width * pixel_size)
+    {
+        pixel::fill(m_memory.first(m_stride * m_height), colour);
+        return bounds();
+    }
+
+    return fill_rect(bounds(), colour);
+}
+
+rectangle2d canvas::fill_rect(rectangle2d r, std::uint32_t colour) noexcept
+{
+    r = intersection(r, bounds());
+
+    for(std::int32_t y = r.offset.y; y < bottom(r); ++y)
+    {
+        pixel::fill(row(r, y), colour);
+    }
+
+    return r;
+}
+
+rectangle2d canvas::blend_rect(rectangle2d r, std::uint32_t colour) noexcept
+{
+    r = intersection(r, bounds());
+
+    for(std::int32_t y = r.offset.y; y < bottom(r); ++y)
+    {
+        pixel::blend(row(r, y), colour);
+    }
+
+    return r;
+}
+
+rectangle2d canvas::stroke_rect(rectangle2d r, std::uint32_t colour, std::int32_t thickness) noexcept
+{
+    if(thickness <= 0 or is_empty(r))
+    {
+        return {};
+    }
+
+    if(thickness * 2 >= r.extent.width or thickness * 2 >= r.extent.height)
+    {
+        return fill_rect(r, colour);
+    }
+
+    const std::int32_t inner = r.extent.height - thickness * 2;
+
+    std::ignore = fill_rect({.offset = r.offset, .extent = {r.extent.width, thickness}}, colour);
+    std::ignore = fill_rect({.offset = {r.offset.x, bottom(r) - thickness}, .extent = {r.extent.width, thickness}}, colour);
+    std::ignore = fill_rect({.offset = {r.offset.x, r.offset.y + thickness}, .extent = {thickness, inner}}, colour);
+    std::ignore = fill_rect({.offset = {right(r) - thickness, r.offset.y + thickness}, .extent = {thickness, inner}}, colour);
+
+    return intersection(r, bounds());
+}
+
+rectangle2d canvas::line(position2d a, position2d b, std::uint32_t colour) noexcept
+{
+    const position2d  first = {std::min(a.x, b.x), std::min(a.y, b.y)};
+    const rectangle2d box   = {.offset = first, .extent = {std::max(a.x, b.x) - first.x + 1, std::max(a.y, b.y) - first.y + 1}};
+
+    // Axis-aligned lines are rectangles, filled a row at a time
+    if(a.x == b.x or a.y == b.y)
+    {
+        return fill_rect(box, colour);
+    }
+
+    const rectangle2d clipped = intersection(box, bounds());
+
+    if(is_empty(clipped))
+    {
+        return {};
+    }
+
+    // Bresenham. Points outside the canvas are skipped rather than clipped analytically: lines are short compared to their cost here
+    const std::int64_t dx  = std::abs(std::int64_t{b.x} - a.x);
+    const std::int64_t dy  = -std::abs(std::int64_t{b.y} - a.y);
+    const std::int32_t sx  = a.x < b.x ? 1 : -1;
+    const std::int32_t sy  = a.y < b.y ? 1 : -1;
+    std::int64_t       err = dx + dy;
+    position2d         p   = a;
+
+    for(;;)
+    {
+        if(p.x >= 0 and p.y >= 0 and std::cmp_less(p.x, m_width) and std::cmp_less(p.y, m_height))
+        {
+            std::memcpy(m_memory.data() + static_cast<std::size_t>(p.y) * m_stride + static_cast<std::size_t>(p.x) * pixel_size, &colour, pixel_size);
+        }
+
+        if(p == b)
+        {
+            break;
+        }
+
+        const std::int64_t e2 = err * 2;
+
+        if(e2 >= dy)
+        {
+            err += dy;
+            p.x += sx;
+        }
+
+        if(e2 <= dx)
+        {
+            err += dx;
+            p.y += sy;
+        }
+    }
+
+    return clipped;
+}
+
+[[nodiscard]] rectangle2d canvas::clip(const image_view& image, rectangle2d& source, position2d at) const noexcept
+{
+    const rectangle2d inside = intersection(source, extent_of(image.width, image.height));
+
+    at.x += inside.offset.x - source.offset.x;
+    at.y += inside.offset.y - source.offset.y;
+
+    const rectangle2d target = intersection({.offset = at, .extent = inside.extent}, bounds());
+
+    source = {.offset = {inside.offset.x + target.offset.x - at.x, inside.offset.y + target.offset.y - at.y}, .extent = target.extent};
+
+    return target;
+}
+
+rectangle2d canvas::blit(const image_view& image, rectangle2d source, position2d at) noexcept
+{
+    const rectangle2d target = clip(image, source, at);
+
+    if(is_empty(target))
+    {
+        return {};
+    }
+
+    // When the image overlaps the canvas, rows must be copied away from the direction the pixels move to, as memmove does within a row
+    const bool backwards = row(target, target.offset.y).data() > image_row(image, source, source.offset.y).data();
+
+    for(std::int32_t i = 0; i < target.extent.height; ++i)
+    {
+        const std::int32_t k   = backwards ? target.extent.height - 1 - i : i;
+        const auto         src = image_row(image, source, source.offset.y + k);
+
+        std::memmove(row(target, target.offset.y + k).data(), src.data(), src.size_bytes());
+    }
+
+    return target;
+}
+
+rectangle2d canvas::blit(const image_view& image, position2d at) noexcept { return blit(image, extent_of(image.width, image.height), at); }
+
+rectangle2d canvas::blend(const image_view& image, rectangle2d source, position2d at) noexcept
+{
+    const rectangle2d target = clip(image, source, at);
+
+    for(std::int32_t i = 0; i < target.extent.height; ++i)
+    {
+        pixel::blend(row(target, target.offset.y + i), image_row(image, source, source.offset.y + i));
+    }
+
+    return target;
+}
+
+rectangle2d canvas::blend(const image_view& image, position2d at) noexcept { return blend(image, extent_of(image.width, image.height), at); }
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
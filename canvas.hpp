@@ -0,0 +1,157 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_CANVAS_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_CANVAS_HPP
+
+#include "shm_buffer.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/// Read-only view over 32-bit pixels, whose rows are stride bytes apart.
+struct image_view
+{
+    std::span<const std::byte> memory = {};
+    std::size_t                width  = 0;
+    std::size_t                height = 0;
+    std::size_t                stride = 0;
+};
+
+/// Returns a view over the pixels of a buffer.
+/// @pre The buffer format must have 4 bytes per pixel.
+[[nodiscard]] image_view view(const shm_buffer& buffer) noexcept;
+
+/**
+ * Non-owning view over 32-bit pixels, as ARGB8888 or XRGB8888, drawn to with the pixel kernels of the detected instruction set.
+ * Colours are 0xAARRGGBB values. Blending assumes premultiplied alpha, as wl_shm does.
+ * Every primitive clips to the canvas and returns the area it modified, which can be passed to window::damage. This area is empty if nothing
+ * was drawn.
+ */
+class canvas
+{
+public:
+
+    /**
+     * Constructor.
+     * @param memory Pixels. The first pixel of row y starts at y * stride.
+     * @param width Width of the canvas, in pixels.
+     * @param height Height of the canvas, in pixels.
+     * @param stride Distance between two rows, in bytes.
+     * @pre stride >= width * 4, and memory must hold height rows.
+     */
+    canvas(std::span<std::byte> memory, std::size_t width, std::size_t height, std::size_t stride) noexcept;
+
+    /// Constructor. Draws to the pixels of a buffer.
+    /// @pre The buffer format must have 4 bytes per pixel.
+    explicit canvas(shm_buffer& buffer) noexcept;
+
+    [[nodiscard]] auto width() const noexcept { return m_width; }
+    [[nodiscard]] auto height() const noexcept { return m_height; }
+    [[nodiscard]] auto stride() const noexcept { return m_stride; }
+
+    [[nodiscard]] std::span<std::byte> memory() noexcept { return m_memory; }
+
+    [[nodiscard]] image_view view() const noexcept { return {.memory = m_memory, .width = m_width, .height = m_height, .stride = m_stride}; }
+
+    /// Returns the rectangle covering the whole canvas.
+    [[nodiscard]] rectangle2d bounds() const noexcept;
+
+    /// Fills the whole canvas with a colour.
+    rectangle2d clear(std::uint32_t colour) noexcept;
+
+    /// Replaces the pixels of a rectangle with a colour.
+    rectangle2d fill_rect(rectangle2d r, std::uint32_t colour) noexcept;
+
+    /// Composites a premultiplied colour over the pixels of a rectangle.
+    rectangle2d blend_rect(rectangle2d r, std::uint32_t colour) noexcept;
+
+    /**
+     * Draws the outline of a rectangle, inside its bounds.
+     * @param thickness Width of the outline, in pixels. Outlines thicker than half the rectangle fill it.
+     */
+    rectangle2d stroke_rect(rectangle2d r, std::uint32_t colour, std::int32_t thickness = 1) noexcept;
+
+    /// Draws a one pixel wide line from a to b, both included.
+    rectangle2d line(position2d a, position2d b, std::uint32_t colour) noexcept;
+
+    /**
+     * Copies a rectangle of an image to the canvas, clipped to both.
+     * The image may be a view of this canvas: overlapping areas are copied as if through a temporary image.
+     * @param source Rectangle of the image to copy.
+     * @param at Position of the top-left corner of source in the canvas.
+     */
+    rectangle2d blit(const image_view& image, rectangle2d source, position2d at) noexcept;
+
+    /// Same as blit(const image_view&, rectangle2d, position2d), copying the whole image.
+    rectangle2d blit(const image_view& image, position2d at) noexcept;
+
+    /**
+     * Composites a rectangle of an image over the canvas, clipped to both.
+     * @param image Premultiplied pixels. Must not overlap the canvas.
+     * @param source Rectangle of the image to composite.
+     * @param at Position of the top-left corner of source in the canvas.
+     */
+    rectangle2d blend(const image_view& image, rectangle2d source, position2d at) noexcept;
+
+    /// Same as blend(const image_view&, rectangle2d, position2d), compositing the whole image.
+    rectangle2d blend(const image_view& image, position2d at) noexcept;
+
+    void swap(canvas& other) noexcept
+    {
+        std::swap(m_memory, other.m_memory);
+        std::swap(m_width, other.m_width);
+        std::swap(m_height, other.m_height);
+        std::swap(m_stride, other.m_stride);
+    }
+
+    friend void swap(canvas& a, canvas& b) noexcept { a.swap(b); }
+
+private:
+
+    /// Returns the pixels of r in row y, in canvas coordinates.
+    /// @pre r must be inside the canvas.
+    [[nodiscard]] std::span<std::byte> row(const rectangle2d& r, std::int32_t y) noexcept;
+
+    /// Clips the source rectangle of a blit to the image and the canvas. Returns the destination rectangle and updates source.
+    [[nodiscard]] rectangle2d clip(const image_view& image, rectangle2d& source, position2d at) const noexcept;
+
+    std::span<std::byte> m_memory = {};
+    std::size_t          m_width  = 0;
+    std::size_t          m_height = 0;
+    std::size_t          m_stride = 0;
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_CANVAS_HPP
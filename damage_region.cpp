@@ -0,0 +1,170 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "damage_region.hpp"
+#include "protocol_stats.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+[[nodiscard]] constexpr std::int32_t right(const rectangle2d& r) noexcept { return r.offset.x + r.extent.width; }
+[[nodiscard]] constexpr std::int32_t bottom(const rectangle2d& r) noexcept { return r.offset.y + r.extent.height; }
+
+[[nodiscard]] constexpr bool is_empty(const rectangle2d& r) noexcept { return r.extent.width <= 0 or r.extent.height <= 0; }
+
+[[nodiscard]] constexpr std::int64_t area(const rectangle2d& r) noexcept
+{
+    return static_cast<std::int64_t>(r.extent.width) * static_cast<std::int64_t>(r.extent.height);
+}
+
+[[nodiscard]] constexpr rectangle2d from_edges(std::int32_t l, std::int32_t t, std::int32_t r, std::int32_t b) noexcept
+{
+    return {.offset = {l, t}, .extent = {r - l, b - t}};
+}
+
+[[nodiscard]] constexpr rectangle2d intersection(const rectangle2d& a, const rectangle2d& b) noexcept
+{
+    return from_edges(
+        std::max(a.offset.x, b.offset.x), std::max(a.offset.y, b.offset.y), std::min(right(a), right(b)), std::min(bottom(a), bottom(b)));
+}
+
+[[nodiscard]] constexpr rectangle2d bounding_box(const rectangle2d& a, const rectangle2d& b) noexcept
+{
+    return from_edges(
+        std::min(a.offset.x, b.offset.x), std::min(a.offset.y, b.offset.y), std::max(right(a), right(b)), std::max(bottom(a), bottom(b)));
+}
+
+/// True if the rectangles overlap or are adjacent, in which case their bounding box is usually a tight enough approximation.
+[[nodiscard]] constexpr bool touching(const rectangle2d& a, const rectangle2d& b) noexcept
+{
+    return a.offset.x <= right(b) and b.offset.x <= right(a) and a.offset.y <= bottom(b) and b.offset.y <= bottom(a);
+}
+
+} // namespace
+
+void damage_region::clip(dimension2d extent) noexcept
+{
+    m_extent = extent;
+
+    const rectangle2d bounds = {.offset = {0, 0}, .extent = m_extent};
+
+    for(std::size_t i = 0; i < m_count;)
+    {
+        m_rectangles[i] = intersection(m_rectangles[i], bounds);
+
+        if(is_empty(m_rectangles[i]))
+        {
+            erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void damage_region::add(rectangle2d r) noexcept
+{
+    r = intersection(r, {.offset = {0, 0}, .extent = m_extent});
+
+    if(is_empty(r))
+    {
+        return;
+    }
+
+    // Merging may make the new rectangle touch others, hence the restart after each merge
+    for(std::size_t i = 0; i < m_count;)
+    {
+        if(touching(m_rectangles[i], r))
+        {
+            r = bounding_box(m_rectangles[i], r);
+            erase(i);
+            i = 0;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    if(m_count < max_rectangles)
+    {
+        m_rectangles[m_count++] = r;
+        return;
+    }
+
+    // Full: merge with the rectangle whose area grows the least
+    std::size_t  best      = 0;
+    std::int64_t best_cost = std::numeric_limits<std::int64_t>::max();
+
+    for(std::size_t i = 0; i < m_count; ++i)
+    {
+        const auto cost = area(bounding_box(m_rectangles[i], r)) - area(m_rectangles[i]);
+
+        if(cost < best_cost)
+        {
+            best      = i;
+            best_cost = cost;
+        }
+    }
+
+    const auto merged = bounding_box(m_rectangles[best], r);
+    erase(best);
+    add(merged);
+}
+
+void damage_region::flush(wl_surface* surface) noexcept
+{
+    const bool buffer_coordinates = wl_surface_get_version(surface) >= WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION;
+
+    for(const auto& r : rectangles())
+    {
+        if(buffer_coordinates)
+        {
+            protocol_stats::send<WL_SURFACE_DAMAGE_BUFFER>(
+                wl_surface_damage_buffer, surface, r.offset.x, r.offset.y, r.extent.width, r.extent.height);
+        }
+        else
+        {
+            // The window does not scale its buffer, surface and buffer coordinates are the same
+            protocol_stats::send<WL_SURFACE_DAMAGE>(
+                wl_surface_damage, surface, r.offset.x, r.offset.y, r.extent.width, r.extent.height);
+        }
+    }
+
+    clear();
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
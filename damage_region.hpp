@@ -0,0 +1,103 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_DAMAGE_REGION_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_DAMAGE_REGION_HPP
+
+#include "types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Accumulates the areas of a buffer that changed since the last commit, in buffer coordinates.
+ * Rectangles are clipped to the buffer extent, and overlapping or touching rectangles are merged. The number of rectangles is bounded:
+ * past max_rectangles, a new rectangle is merged with the one it enlarges the least. This class never allocates.
+ */
+class damage_region
+{
+public:
+
+    static constexpr std::size_t max_rectangles = 8;
+
+    damage_region() noexcept = default;
+
+    explicit damage_region(dimension2d extent) noexcept : m_extent{extent} {}
+
+    /// Changes the extent rectangles are clipped to. Accumulated rectangles are clipped as well.
+    void clip(dimension2d extent) noexcept;
+
+    /// Adds a rectangle to the region. Empty rectangles, once clipped, are ignored.
+    void add(rectangle2d r) noexcept;
+
+    /// Marks the whole extent as damaged.
+    void add_all() noexcept { add({.offset = {0, 0}, .extent = m_extent}); }
+
+    /// Forgets every accumulated rectangle.
+    void clear() noexcept { m_count = 0; }
+
+    /**
+     * Posts the accumulated rectangles to a surface and clears the region. Must be called before committing the surface.
+     * Uses wl_surface.damage_buffer when the surface supports it, and wl_surface.damage otherwise.
+     */
+    void flush(wl_surface* surface) noexcept;
+
+    [[nodiscard]] bool empty() const noexcept { return m_count == 0; }
+
+    [[nodiscard]] std::span<const rectangle2d> rectangles() const noexcept { return std::span{m_rectangles}.first(m_count); }
+
+    [[nodiscard]] const auto& extent() const noexcept { return m_extent; }
+
+    void swap(damage_region& other) noexcept
+    {
+        m_extent.swap(other.m_extent);
+        m_rectangles.swap(other.m_rectangles);
+        std::swap(m_count, other.m_count);
+    }
+
+    friend void swap(damage_region& a, damage_region& b) noexcept { a.swap(b); }
+
+private:
+
+    /// Removes the rectangle at index, without preserving the order.
+    void erase(std::size_t index) noexcept { m_rectangles[index] = m_rectangles[--m_count]; }
+
+    dimension2d                              m_extent     = {};
+    std::array<rectangle2d, max_rectangles> m_rectangles = {};
+    std::size_t                              m_count      = 0;
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_DAMAGE_REGION_HPP
@@ -27,11 +27,21 @@
  */
 
 #include "display.hpp"
-#include "registry.hpp"
+#include "protocol_stats.hpp"
+#include "shm_arena.hpp"
+#include "wp/generated/presentation-time-client-protocol.hpp"
 #include "xdg/generated/shell-client-protocol.hpp"
 #include "zxdg/generated/decoration-client-protocol.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 namespace fubuki::io::platform::linux_bsd::wayland
 {
@@ -39,72 +49,411 @@ namespace fubuki::io::platform::linux_bsd::wayland
 namespace
 {
 
-namespace callback::registry
+namespace callback::shm
 {
 
-void global(void* data, wl_registry* registry, std::uint32_t name, const char* c_interface, std::uint32_t /*version*/) noexcept
+void format(void* data, wl_shm* /*shm*/, std::uint32_t f) noexcept
 {
-    auto* const dp = static_cast<display::global*>(data);
+    auto* const formats = static_cast<std::vector<wl_shm_format>*>(data);
 
-    const std::string_view interface = c_interface;
+    formats->push_back(static_cast<wl_shm_format>(f));
+}
+
+} // namespace callback::shm
+
+namespace callback::presentation
+{
+
+void clock_id(void* data, wp_presentation* /*presentation*/, std::uint32_t clock) noexcept
+{
+    *static_cast<int*>(data) = static_cast<int>(clock);
+}
+
+} // namespace callback::presentation
+
+namespace callback::wm_base
+{
+
+void ping(void* /*data*/, xdg_wm_base* handle, std::uint32_t serial) noexcept
+{
+    protocol_stats::send<XDG_WM_BASE_PONG>(xdg_wm_base_pong, handle, serial);
+}
+
+} // namespace callback::wm_base
+
+namespace callback::sync
+{
+
+void done(void* data, wl_callback* callback, std::uint32_t /*serial*/) noexcept
+{
+    wl_callback_destroy(callback);
+    std::coroutine_handle<>::from_address(data).resume();
+}
+
+} // namespace callback::sync
+
+namespace listener
+{
+
+using protocol_stats::counted;
+
+constexpr wl_callback_listener sync{.done = counted<&wl_callback_listener::done, callback::sync::done>};
+
+constexpr wl_shm_listener shm{.format = counted<&wl_shm_listener::format, callback::shm::format>};
+
+// The seat is bound up to version 7: every event up to this version needs a callback. Input devices are created by each window
+constexpr wl_seat_listener seat{
+    .capabilities = counted<&wl_seat_listener::capabilities>,
+    .name         = counted<&wl_seat_listener::name>,
+};
+
+constexpr xdg_wm_base_listener wm_base{.ping = counted<&xdg_wm_base_listener::ping, callback::wm_base::ping>};
+
+constexpr wp_presentation_listener presentation{.clock_id = counted<&wp_presentation_listener::clock_id, callback::presentation::clock_id>};
+
+} // namespace listener
+
+/// How a global is bound.
+struct binding
+{
+    const wl_interface* description = nullptr;
+
+    /// Highest version the listeners of this library handle. Events of later versions would reach null callbacks.
+    std::uint32_t supported = 0;
+
+    std::uint32_t display::global_versions::* version = nullptr;
+
+    /// Set for globals only bound on first use.
+    std::optional<display::lazy_global> lazy = {};
+
+    /// Stores the bound global, and adds its listener.
+    void (*store)(display::registry_state& state, void* proxy) noexcept = nullptr;
 
-    if(interface == wl_compositor_interface.name)
+    /// Destroys the global, if bound.
+    void (*destroy)(display::global& g, const display::global_versions& v) noexcept = nullptr;
+};
+
+using global_versions = display::global_versions;
+
+constexpr std::array bindings = {
+    binding{
+        .description = &wl_compositor_interface,
+        .supported   = 6,
+        .version     = &global_versions::compositor,
+        .store       = [](display::registry_state& s, void* p) noexcept { s.globals->compositor = static_cast<wl_compositor*>(p); },
+        .destroy     = [](display::global& g, const global_versions& /*v*/) noexcept { wl_compositor_destroy(g.compositor); },
+    },
+    binding{
+        .description = &wl_subcompositor_interface,
+        .supported   = 1,
+        .version     = &global_versions::subcompositor,
+        .lazy        = display::lazy_global::subcompositor,
+        .store       = [](display::registry_state& s, void* p) noexcept { s.globals->subcompositor = static_cast<wl_subcompositor*>(p); },
+        .destroy     = [](display::global& g, const global_versions& /*v*/) noexcept
+        { protocol_stats::send<WL_SUBCOMPOSITOR_DESTROY>(wl_subcompositor_destroy, g.subcompositor); },
+    },
+    binding{
+        .description = &wl_shm_interface,
+        .supported   = 2,
+        .version     = &global_versions::shm,
+        .store =
+            [](display::registry_state& s, void* p) noexcept
+        {
+            s.globals->shm = static_cast<wl_shm*>(p);
+            wl_shm_add_listener(s.globals->shm, std::addressof(listener::shm), s.formats);
+        },
+        .destroy = [](display::global& g, const global_versions& v) noexcept
+        { v.shm_release() ? protocol_stats::send<WL_SHM_RELEASE>(wl_shm_release, g.shm) : wl_shm_destroy(g.shm); },
+    },
+    binding{
+        .description = &wl_seat_interface,
+        .supported   = 7,
+        .version     = &global_versions::seat,
+        .store =
+            [](display::registry_state& s, void* p) noexcept
+        {
+            s.globals->seat = static_cast<wl_seat*>(p);
+            wl_seat_add_listener(s.globals->seat, std::addressof(listener::seat), nullptr);
+        },
+        .destroy = [](display::global& g, const global_versions& v) noexcept
+        { v.seat_release() ? protocol_stats::send<WL_SEAT_RELEASE>(wl_seat_release, g.seat) : wl_seat_destroy(g.seat); },
+    },
+    binding{
+        .description = &xdg_wm_base_interface,
+        .supported   = 6,
+        .version     = &global_versions::wm_base,
+        .store =
+            [](display::registry_state& s, void* p) noexcept
+        {
+            s.globals->wm_base = static_cast<xdg_wm_base*>(p);
+            xdg_wm_base_add_listener(s.globals->wm_base, std::addressof(listener::wm_base), nullptr);
+        },
+        .destroy = [](display::global& g, const global_versions& /*v*/) noexcept
+        { protocol_stats::send<XDG_WM_BASE_DESTROY>(xdg_wm_base_destroy, g.wm_base); },
+    },
+    binding{
+        .description = &zxdg_decoration_manager_v1_interface,
+        .supported   = 1,
+        .version     = &global_versions::decoration_manager,
+        .store = [](display::registry_state& s, void* p) noexcept
+        { s.globals->decoration_manager = static_cast<zxdg_decoration_manager_v1*>(p); },
+        .destroy = [](display::global& g, const global_versions& /*v*/) noexcept
+        { protocol_stats::send<ZXDG_DECORATION_MANAGER_V1_DESTROY>(zxdg_decoration_manager_v1_destroy, g.decoration_manager); },
+    },
+    binding{
+        .description = &wp_presentation_interface,
+        .supported   = 1,
+        .version     = &global_versions::presentation,
+        .store =
+            [](display::registry_state& s, void* p) noexcept
+        {
+            s.globals->presentation = static_cast<wp_presentation*>(p);
+            wp_presentation_add_listener(s.globals->presentation, std::addressof(listener::presentation), s.clock);
+        },
+        .destroy = [](display::global& g, const global_versions& /*v*/) noexcept
+        { protocol_stats::send<WP_PRESENTATION_DESTROY>(wp_presentation_destroy, g.presentation); },
+    },
+};
+
+/// Binds a global with its negotiated version, and stores it. The version is reset if binding failed.
+void bind(const binding& b, display::registry_state& state, wl_registry* registry, std::uint32_t name) noexcept
+{
+    auto& version = state.versions->*b.version;
+
+    if(void* const proxy = protocol_stats::send<WL_REGISTRY_BIND>(wl_registry_bind, registry, name, b.description, version); proxy != nullptr)
     {
-        dp->compositor = static_cast<wl_compositor*>(wl_registry_bind(registry, name, &wl_compositor_interface, 4));
+        b.store(state, proxy);
     }
-
-    else if(interface == wl_subcompositor_interface.name)
+    else
     {
-        dp->subcompositor = static_cast<wl_subcompositor*>(wl_registry_bind(registry, name, &wl_subcompositor_interface, 1));
+        version = 0;
     }
+}
+
+namespace callback::registry
+{
+
+void global(void* data, wl_registry* registry, std::uint32_t name, const char* c_interface, std::uint32_t version) noexcept
+{
+    auto* const state = static_cast<display::registry_state*>(data);
 
-    else if(interface == wl_shm_interface.name)
+    const std::string_view interface = c_interface;
+
+    // Outputs come and go as screens are plugged
+    if(interface == wl_output_interface.name)
     {
-        dp->shm = static_cast<wl_shm*>(wl_registry_bind(registry, name, &wl_shm_interface, 1));
+        state->outputs->bind(registry, name, version);
+        return;
     }
 
-    else if(interface == wl_seat_interface.name)
+    // Other globals are only bound once
+    if(not state->startup)
     {
-        constexpr auto seat_interface_v = 7;
-        dp->seat                        = static_cast<wl_seat*>(wl_registry_bind(registry, name, &wl_seat_interface, seat_interface_v));
+        return;
     }
 
-    else if(interface == xdg_wm_base_interface.name)
+    const auto* const b = std::ranges::find(bindings, interface, [](const binding& e) { return std::string_view{e.description->name}; });
+
+    if(b == bindings.end())
     {
-        dp->wm_base = static_cast<xdg_wm_base*>(wl_registry_bind(registry, name, &xdg_wm_base_interface, 1));
+        return;
     }
 
-    else if(interface == zxdg_decoration_manager_v1_interface.name)
+    // Binding a version the compositor did not advertise is a protocol error, one libwayland does not know is one too
+    state->versions->*b->version = std::min({version, b->supported, static_cast<std::uint32_t>(b->description->version)});
+
+    if(b->lazy)
     {
-        dp->decoration_manager = static_cast<zxdg_decoration_manager_v1*>(wl_registry_bind(registry, name, &zxdg_decoration_manager_v1_interface, 1));
+        (*state->lazy)[static_cast<std::size_t>(*b->lazy)].name = name;
+        return;
     }
+
+    bind(*b, *state, registry, name);
 }
 
-void global_remove(void* /*data*/, wl_registry* /*registry*/, std::uint32_t /*name*/) noexcept {}
+void global_remove(void* data, wl_registry* /*registry*/, std::uint32_t name) noexcept
+{
+    // Other globals are never removed in practice
+    std::ignore = static_cast<display::registry_state*>(data)->outputs->remove(name);
+}
 
 } // namespace callback::registry
 
 namespace listener
 {
 
-constexpr wl_registry_listener registry{.global = callback::registry::global, .global_remove = callback::registry::global_remove};
+using protocol_stats::counted;
+
+constexpr wl_registry_listener registry{
+    .global        = counted<&wl_registry_listener::global, callback::registry::global>,
+    .global_remove = counted<&wl_registry_listener::global_remove, callback::registry::global_remove>,
+};
 
 } // namespace listener
 
 } // namespace
 
+display::~display() noexcept
+{
+    // The pools of the arena must be destroyed while the connection is still alive
+    m_arena.reset();
+
+    // Same for the outputs, the other globals and the registry
+    m_outputs = output_list{};
+
+    release();
+
+    if(m_registry != nullptr)
+    {
+        wl_registry_destroy(m_registry);
+    }
+
+    if(m_handle != nullptr)
+    {
+        wl_display_disconnect(m_handle);
+    }
+}
+
+void display::arena_deleter::operator()(shm_arena* a) const noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete a;
+}
+
+[[nodiscard]]
+shm_arena& display::arena()
+{
+    if(not m_arena)
+    {
+        m_arena.reset(new shm_arena{m_globals});
+    }
+
+    return *m_arena;
+}
+
+void display::repoint() noexcept
+{
+    // wl_shm.format events are received in m_formats
+    if(m_globals.shm != nullptr)
+    {
+        wl_shm_set_user_data(m_globals.shm, std::addressof(m_formats));
+    }
+
+    // wp_presentation.clock_id events are received in m_presentation_clock
+    if(m_globals.presentation != nullptr)
+    {
+        wp_presentation_set_user_data(m_globals.presentation, std::addressof(m_presentation_clock));
+    }
+
+    m_registry_state.globals  = std::addressof(m_globals);
+    m_registry_state.versions = std::addressof(m_versions);
+    m_registry_state.lazy     = std::addressof(m_lazy);
+    m_registry_state.formats  = std::addressof(m_formats);
+    m_registry_state.clock    = std::addressof(m_presentation_clock);
+    m_registry_state.outputs  = std::addressof(m_outputs);
+
+    if(m_registry != nullptr)
+    {
+        wl_registry_set_user_data(m_registry, std::addressof(m_registry_state));
+    }
+}
+
+void display::release() noexcept
+{
+    for(const auto& b : bindings)
+    {
+        const bool bound = b.lazy ? m_lazy[static_cast<std::size_t>(*b.lazy)].bound : true;
+
+        // Versions are only set for the globals the compositor advertised, and reset if binding them failed
+        if(bound and m_versions.*b.version != 0)
+        {
+            b.destroy(m_globals, m_versions);
+        }
+    }
+
+    m_globals = {};
+}
+
+[[nodiscard]]
+bool display::supports(const global& g, wl_shm_format f) noexcept
+{
+    // Required by the protocol, whether the compositor advertised them or not
+    if(f == WL_SHM_FORMAT_ARGB8888 or f == WL_SHM_FORMAT_XRGB8888)
+    {
+        return true;
+    }
+
+    if(g.shm == nullptr)
+    {
+        return false;
+    }
+
+    const auto* const formats = static_cast<const std::vector<wl_shm_format>*>(wl_shm_get_user_data(g.shm));
+
+    return formats != nullptr and std::ranges::find(*formats, f) != formats->end();
+}
+
+const display::global& display::require(lazy_global g) noexcept
+{
+    auto& lazy = m_lazy[static_cast<std::size_t>(g)];
+
+    const auto* const b = std::ranges::find(bindings, std::optional{g}, &binding::lazy);
+
+    if(not lazy.bound and m_versions.*b->version != 0)
+    {
+        lazy.bound = true;
+        bind(*b, m_registry_state, m_registry, lazy.name);
+    }
+
+    return m_globals;
+}
+
+[[nodiscard]] bool display::sync_awaitable::await_suspend(std::coroutine_handle<> h) noexcept
+{
+    wl_callback* const callback = protocol_stats::send<WL_DISPLAY_SYNC>(wl_display_sync, m_display);
+
+    if(callback == nullptr)
+    {
+        return false;
+    }
+
+    wl_callback_add_listener(callback, std::addressof(listener::sync), h.address());
+
+    return true;
+}
+
+int display::roundtrip() noexcept
+{
+    protocol_stats::flush(m_handle);
+
+    const auto start  = std::chrono::steady_clock::now();
+    const int  result = wl_display_roundtrip(m_handle);
+
+    protocol_stats::record_roundtrip(std::chrono::steady_clock::now() - start);
+
+    return result;
+}
+
 [[nodiscard]]
 auto display::create() noexcept -> std::optional<any_call_info>
 {
-    auto r = registry::make(m_handle);
+    m_registry = protocol_stats::send<WL_DISPLAY_GET_REGISTRY>(wl_display_get_registry, m_handle);
 
-    if(not r)
+    if(m_registry == nullptr)
     {
         return any_call_info{};
     }
 
-    wl_registry_add_listener(r->handle(), std::addressof(listener::registry), std::addressof(m_globals));
-    wl_display_roundtrip(m_handle);
+    repoint();
+
+    wl_registry_add_listener(m_registry, std::addressof(listener::registry), std::addressof(m_registry_state));
+    roundtrip();
+
+    // wl_shm sends its formats, wp_presentation its clock and each wl_output its state once bound, which happens during the first roundtrip.
+    // This is the only other roundtrip: windows and screen::enumerate reuse what it received
+    roundtrip();
+
+    m_registry_state.startup = false;
 
     return {};
 }
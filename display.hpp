@@ -29,19 +29,32 @@
 #ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_DISPLAY_HPP
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_DISPLAY_HPP
 
+#include "output_list.hpp"
+
+#include <algorithm>
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <expected>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include <wayland-client.h>
 
 struct xdg_wm_base;
 struct zxdg_decoration_manager_v1;
+struct wp_presentation;
 
 namespace fubuki::io::platform::linux_bsd::wayland
 {
 
+class shm_arena;
+
 class display
 {
     struct token
@@ -56,12 +69,13 @@ public:
     struct global
     {
         wl_compositor*    compositor    = nullptr;
-        wl_subcompositor* subcompositor = nullptr;
+        wl_subcompositor* subcompositor = nullptr; ///< Null until required. @see require
         wl_shm*           shm           = nullptr;
         wl_seat*          seat          = nullptr;
 
         xdg_wm_base*                wm_base            = nullptr;
         zxdg_decoration_manager_v1* decoration_manager = nullptr;
+        wp_presentation*            presentation       = nullptr;
 
         void swap(global& other) noexcept
         {
@@ -72,11 +86,74 @@ public:
 
             std::swap(wm_base, other.wm_base);
             std::swap(decoration_manager, other.decoration_manager);
+            std::swap(presentation, other.presentation);
         }
 
         friend void swap(global& a, global& b) noexcept { a.swap(b); }
     };
 
+    /**
+     * Versions of the globals: the lowest of what the compositor advertised and what this library handles. 0 if not advertised.
+     * Objects created from a global have its version, which tells which requests they accept and which events they may receive.
+     */
+    struct global_versions
+    {
+        std::uint32_t compositor         = 0;
+        std::uint32_t subcompositor      = 0;
+        std::uint32_t shm                = 0;
+        std::uint32_t seat               = 0;
+        std::uint32_t wm_base            = 0;
+        std::uint32_t decoration_manager = 0;
+        std::uint32_t presentation       = 0;
+
+        /// Returns true if surfaces accept damage in buffer coordinates, which does not depend on their scale or transform.
+        [[nodiscard]] bool damage_buffer() const noexcept { return compositor >= 4; }
+
+        /// Returns true if surfaces receive the preferred_buffer_scale and preferred_buffer_transform events.
+        [[nodiscard]] bool preferred_buffer_scale() const noexcept { return compositor >= 6; }
+
+        /// Returns true if wl_shm can be released rather than leaked until the connection is closed.
+        [[nodiscard]] bool shm_release() const noexcept { return shm >= 2; }
+
+        /// Returns true if seats can be released rather than leaked until the connection is closed.
+        [[nodiscard]] bool seat_release() const noexcept { return seat >= 5; }
+
+        /// Returns true if toplevels receive their bounds and the capabilities of the window manager.
+        [[nodiscard]] bool wm_capabilities() const noexcept { return wm_base >= 5; }
+
+        /// Returns true if toplevels receive the suspended state, when they are hidden and their frames can be skipped.
+        [[nodiscard]] bool suspended_state() const noexcept { return wm_base >= 6; }
+    };
+
+    /// Globals that are rarely used, and only bound on first use. @see require
+    enum class lazy_global : std::uint8_t
+    {
+        subcompositor,
+    };
+
+    static constexpr std::size_t lazy_global_count = 1;
+
+    /// Registry name of a lazy global, and whether it was bound yet.
+    struct lazy_binding
+    {
+        std::uint32_t name  = 0;
+        bool          bound = false;
+    };
+
+    using lazy_bindings = std::array<lazy_binding, lazy_global_count>;
+
+    /// Where the registry callbacks store what they receive. Points to members of the display, and is re-pointed when it moves.
+    struct registry_state
+    {
+        global*                     globals  = nullptr;
+        global_versions*            versions = nullptr;
+        lazy_bindings*              lazy     = nullptr;
+        std::vector<wl_shm_format>* formats  = nullptr;
+        int*                        clock    = nullptr;
+        output_list*                outputs  = nullptr;
+        bool                        startup  = true; ///< Globals other than outputs are only bound while the display is created.
+    };
+
     display(const char* name = nullptr) : m_handle{wl_display_connect(name)}
     {
         if(m_handle == nullptr)
@@ -118,37 +195,129 @@ public:
         return result;
     }
 
-    ~display() noexcept
-    {
-        if(m_handle != nullptr)
-        {
-            wl_display_disconnect(m_handle);
-        }
-    }
+    ~display() noexcept;
 
     [[nodiscard]] explicit operator bool() const noexcept { return m_handle != nullptr; }
 
     [[nodiscard]] auto*       handle() noexcept { return m_handle; }
     [[nodiscard]] const auto* handle() const noexcept { return m_handle; }
 
+    /// Awaitable of sync.
+    class sync_awaitable
+    {
+    public:
+
+        explicit sync_awaitable(wl_display* d) noexcept : m_display{d} {}
+
+        [[nodiscard]] bool await_ready() const noexcept { return m_display == nullptr; }
+
+        /// Sends wl_display.sync, whose done event resumes the coroutine. Does not suspend if the request could not be created.
+        [[nodiscard]] bool await_suspend(std::coroutine_handle<> h) noexcept;
+
+        void await_resume() const noexcept {}
+
+    private:
+
+        wl_display* m_display;
+    };
+
+    /**
+     * Returns an awaitable that resumes once the compositor processed every request sent so far, like roundtrip, without blocking.
+     * The coroutine is resumed from whatever dispatches the default queue, event_loop for example, so that many of them overlap on one thread.
+     */
+    [[nodiscard]] sync_awaitable sync() noexcept { return sync_awaitable{m_handle}; }
+
+    /**
+     * Flushes the pending requests, then blocks until the compositor processed them, dispatching the events of the default queue meanwhile.
+     * Counted by protocol_stats, unlike a direct call to wl_display_roundtrip.
+     * @returns The number of dispatched events, or -1 on error.
+     */
+    int roundtrip() noexcept;
+
     [[nodiscard]] const auto& globals() const noexcept { return m_globals; }
 
+    /// Returns the versions the globals are bound with, lazy ones included even before they are bound.
+    [[nodiscard]] const auto& versions() const noexcept { return m_versions; }
+
+    /**
+     * Binds a lazy global, unless it is bound already or the compositor does not support it.
+     * Event queues created before do not wrap it.
+     * @returns The globals, where the lazy global is null if the compositor does not support it.
+     */
+    const global& require(lazy_global g) noexcept;
+
+    /// Returns the pixel formats the compositor advertised for shared memory buffers, in the order they were received.
+    [[nodiscard]] const auto& formats() const noexcept { return m_formats; }
+
+    /// Returns true if the compositor supports shared memory buffers of a given format. ARGB8888 and XRGB8888 are always supported.
+    [[nodiscard]] bool supports(wl_shm_format f) const noexcept { return supports(m_globals, f); }
+
+    /// Same as supports(wl_shm_format), from the globals of a display: the formats are received by its wl_shm.
+    [[nodiscard]] static bool supports(const global& g, wl_shm_format f) noexcept;
+
+    /**
+     * Returns the outputs of the compositor, bound along with the other globals. Their state is received during the creation of the display,
+     * and outputs are added, updated and removed whenever the display is dispatched, so that reading them never costs a roundtrip.
+     */
+    [[nodiscard]] const auto& outputs() const noexcept { return m_outputs; }
+    [[nodiscard]] auto&       outputs() noexcept { return m_outputs; }
+
+    /**
+     * Returns the clock in which the compositor expresses presentation timestamps, as a clockid_t.
+     * This is CLOCK_MONOTONIC until wp_presentation says otherwise, or if the compositor does not support it.
+     */
+    [[nodiscard]] auto presentation_clock() const noexcept { return m_presentation_clock; }
+
+    /// Returns the shared memory arena of this display, which is created upon first call. Windows allocate their buffers from it.
+    [[nodiscard]] shm_arena& arena();
+
     void swap(display& other) noexcept
     {
         std::swap(m_handle, other.m_handle);
+        std::swap(m_registry, other.m_registry);
+        std::swap(m_registry_state.startup, other.m_registry_state.startup);
         m_globals.swap(other.m_globals);
+        std::swap(m_versions, other.m_versions);
+        m_lazy.swap(other.m_lazy);
+        m_formats.swap(other.m_formats);
+        m_arena.swap(other.m_arena);
+        std::swap(m_presentation_clock, other.m_presentation_clock);
+        m_outputs.swap(other.m_outputs);
+
+        repoint();
+        other.repoint();
     }
 
     friend void swap(display& a, display& b) noexcept { a.swap(b); }
 
 private:
+    // shm_arena is incomplete here
+    struct arena_deleter
+    {
+        void operator()(shm_arena* a) const noexcept;
+    };
+
     display(token) noexcept {}
 
     [[nodiscard]]
     std::optional<any_call_info> create() noexcept;
 
-    wl_display* m_handle  = nullptr;
-    global      m_globals = {};
+    /// Points the user data of the globals whose events are received in this object to it.
+    void repoint() noexcept;
+
+    /// Destroys the globals, with their release request where their version has one.
+    void release() noexcept;
+
+    wl_display*                               m_handle             = nullptr;
+    wl_registry*                              m_registry           = nullptr; ///< Kept to follow outputs as they come and go.
+    registry_state                            m_registry_state     = {};
+    global                                    m_globals            = {};
+    global_versions                           m_versions           = {};
+    lazy_bindings                             m_lazy               = {};
+    std::vector<wl_shm_format>                m_formats            = {};
+    std::unique_ptr<shm_arena, arena_deleter> m_arena              = {};
+    int                                       m_presentation_clock = CLOCK_MONOTONIC;
+    output_list                               m_outputs            = {};
 };
 
 } // namespace fubuki::io::platform::linux_bsd::wayland
@@ -0,0 +1,349 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "event_loop.hpp"
+#include "protocol_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <iostream>
+#include <limits>
+#include <span>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+/// Maximum number of events handled per dispatch. Others are reported by the next epoll_wait.
+constexpr int max_events = 32;
+
+[[nodiscard]] timespec to_timespec(std::chrono::nanoseconds d) noexcept
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(d);
+
+    timespec result = {};
+    result.tv_sec   = seconds.count();
+    result.tv_nsec  = (d - seconds).count();
+
+    return result;
+}
+
+[[nodiscard]] bool control(int epoll, int operation, int fd, std::uint32_t events) noexcept
+{
+    epoll_event e = {.events = events, .data = {.fd = fd}};
+
+    return epoll_ctl(epoll, operation, fd, &e) == 0;
+}
+
+} // namespace
+
+[[nodiscard]] std::optional<event_loop::any_call_info> event_loop::create() noexcept
+{
+    const int epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    if(epoll < 0)
+    {
+        std::cerr << "epoll_create1 failed\n" << std::flush;
+        return any_call_info{};
+    }
+
+    m_epoll = file_descriptor{file_descriptor::handle{epoll}};
+
+    const int wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if(wake < 0)
+    {
+        std::cerr << "eventfd failed\n" << std::flush;
+        return any_call_info{};
+    }
+
+    m_wake = file_descriptor{file_descriptor::handle{wake}};
+
+    if(not control(epoll, EPOLL_CTL_ADD, display_fd(), EPOLLIN) or not control(epoll, EPOLL_CTL_ADD, wake, EPOLLIN))
+    {
+        return any_call_info{};
+    }
+
+    return {};
+}
+
+[[nodiscard]] bool event_loop::watch(int fd, std::uint32_t events, watch_callback callback) noexcept
+{
+    if(m_sources.contains(fd) or not control(this->fd(), EPOLL_CTL_ADD, fd, events))
+    {
+        return false;
+    }
+
+    m_sources.emplace(fd, source{.callback = std::move(callback)});
+
+    return true;
+}
+
+void event_loop::unwatch(int fd) noexcept
+{
+    const auto it = m_sources.find(fd);
+
+    if(it == m_sources.end() or it->second.removed)
+    {
+        return;
+    }
+
+    std::ignore = control(this->fd(), EPOLL_CTL_DEL, fd, 0);
+
+    // The callback may be the one running: it is destroyed once dispatch is done with it
+    if(m_dispatching)
+    {
+        it->second.removed = true;
+        m_removed.push_back(fd);
+    }
+    else
+    {
+        m_sources.erase(it);
+    }
+}
+
+[[nodiscard]] auto event_loop::add_timer(std::chrono::nanoseconds delay, std::chrono::nanoseconds period, timer_callback callback) noexcept
+    -> std::optional<timer>
+{
+    const int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if(fd < 0)
+    {
+        return std::nullopt;
+    }
+
+    file_descriptor owned{file_descriptor::handle{fd}};
+
+    // A null expiration disarms the timer
+    const itimerspec spec = {
+        .it_interval = to_timespec(std::max(period, std::chrono::nanoseconds{0})),
+        .it_value    = to_timespec(std::max(delay, std::chrono::nanoseconds{1})),
+    };
+
+    if(timerfd_settime(fd, 0, &spec, nullptr) != 0 or not control(this->fd(), EPOLL_CTL_ADD, fd, EPOLLIN))
+    {
+        return std::nullopt;
+    }
+
+    m_sources.emplace(fd,
+                      source{
+                          .owned    = std::move(owned),
+                          .callback = [f = std::move(callback)](std::uint32_t) { f(); },
+                          .one_shot = period <= std::chrono::nanoseconds{0},
+                      });
+
+    return timer{fd};
+}
+
+[[nodiscard]] bool event_loop::flush() noexcept
+{
+    const int  sent    = protocol_stats::flush(m_display);
+    const bool pending = sent < 0;
+
+    if(pending and errno != EAGAIN)
+    {
+        return false;
+    }
+
+    // The socket is full: wait until it drains rather than retrying wl_display_flush in a loop
+    if(pending != m_flush_pending)
+    {
+        m_flush_pending = pending;
+        std::ignore     = control(fd(), EPOLL_CTL_MOD, display_fd(), pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN);
+    }
+
+    return true;
+}
+
+void event_loop::collect() noexcept
+{
+    for(const int fd : m_removed)
+    {
+        m_sources.erase(fd);
+    }
+
+    m_removed.clear();
+}
+
+[[nodiscard]] std::expected<std::size_t, event_loop::any_call_info> event_loop::dispatch(std::optional<std::chrono::milliseconds> timeout) noexcept
+{
+    // Events already queued, by a roundtrip for example, must be dispatched first: prepare_read fails until the queue is empty
+    while(wl_display_prepare_read(m_display) != 0)
+    {
+        if(wl_display_dispatch_pending(m_display) < 0)
+        {
+            return std::unexpected{any_call_info{}};
+        }
+    }
+
+    if(not flush())
+    {
+        wl_display_cancel_read(m_display);
+        return std::unexpected{any_call_info{}};
+    }
+
+    const int wait = timeout ? static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(timeout->count(), 0, std::numeric_limits<int>::max()))
+                             : -1;
+
+    std::array<epoll_event, max_events> events = {};
+
+    const auto start = std::chrono::steady_clock::now();
+    const int  count = epoll_wait(fd(), events.data(), max_events, wait);
+
+    protocol_stats::record_wait(std::chrono::steady_clock::now() - start);
+
+    if(count < 0)
+    {
+        wl_display_cancel_read(m_display);
+
+        if(errno == EINTR)
+        {
+            return 0;
+        }
+
+        return std::unexpected{any_call_info{}};
+    }
+
+    const auto ready = std::span{events}.first(static_cast<std::size_t>(count));
+
+    const bool readable = std::ranges::any_of(
+        ready, [fd = display_fd()](const epoll_event& e) { return e.data.fd == fd and (e.events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0; });
+
+    if(readable)
+    {
+        if(wl_display_read_events(m_display) < 0)
+        {
+            return std::unexpected{any_call_info{}};
+        }
+    }
+    else
+    {
+        wl_display_cancel_read(m_display);
+    }
+
+    if(wl_display_dispatch_pending(m_display) < 0)
+    {
+        return std::unexpected{any_call_info{}};
+    }
+
+    std::size_t fired = 0;
+
+    m_dispatching = true;
+
+    for(const auto& e : ready)
+    {
+        const int fd = e.data.fd;
+
+        if(fd == display_fd())
+        {
+            continue; // EPOLLOUT: flushed below
+        }
+
+        if(fd == m_wake.get().value)
+        {
+            std::uint64_t value = 0;
+            std::ignore         = read(fd, &value, sizeof(value));
+            continue;
+        }
+
+        const auto it = m_sources.find(fd);
+
+        if(it == m_sources.end() or it->second.removed)
+        {
+            continue;
+        }
+
+        // Callbacks may add sources: unlike iterators, references survive a rehash
+        auto& s = it->second;
+
+        if(s.owned.valid())
+        {
+            // Also rearms the timer. Fails if the timer did not expire after all, which epoll may report after a timerfd_settime
+            std::uint64_t expirations = 0;
+
+            if(read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+            {
+                continue;
+            }
+        }
+
+        s.callback(e.events);
+        ++fired;
+
+        if(s.one_shot)
+        {
+            unwatch(fd);
+        }
+    }
+
+    m_dispatching = false;
+    collect();
+
+    // Callbacks usually send requests: an application that blocks in its own loop next would otherwise never send them
+    if(not flush())
+    {
+        return std::unexpected{any_call_info{}};
+    }
+
+    return fired;
+}
+
+[[nodiscard]] std::optional<event_loop::any_call_info> event_loop::run() noexcept
+{
+    while(not m_stop.exchange(false))
+    {
+        if(const auto result = dispatch(); not result)
+        {
+            return result.error();
+        }
+    }
+
+    return {};
+}
+
+void event_loop::stop() noexcept
+{
+    m_stop = true;
+    wake();
+}
+
+void event_loop::wake() noexcept
+{
+    const std::uint64_t value = 1;
+    std::ignore               = write(m_wake.get().value, &value, sizeof(value));
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
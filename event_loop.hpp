@@ -0,0 +1,219 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_EVENT_LOOP_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_EVENT_LOOP_HPP
+
+#include "display.hpp"
+#include "file_descriptor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Waits on the display, timers and arbitrary file descriptors with a single epoll instance.
+ * Events are read with the wl_display_prepare_read / wl_display_read_events protocol, so that the loop never blocks inside libwayland, and
+ * requests that do not fit in the socket are flushed when it becomes writable again instead of being retried in a busy loop.
+ * The epoll file descriptor is itself pollable: an application with its own loop can watch fd() and call dispatch with a null timeout when
+ * it becomes readable.
+ * Dispatching is single-threaded. Only wake and stop may be called from other threads.
+ */
+class event_loop
+{
+    struct token
+    {
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    /// Called with the epoll events of a watched file descriptor.
+    using watch_callback = std::function<void(std::uint32_t events)>;
+
+    using timer_callback = std::function<void()>;
+
+    /// Identifies a timer.
+    struct timer
+    {
+        int value = -1;
+
+        [[nodiscard]] friend constexpr bool operator==(const timer& a, const timer& b) noexcept  = default;
+        [[nodiscard]] friend constexpr bool operator!=(const timer& a, const timer& b) noexcept  = default;
+        [[nodiscard]] friend constexpr auto operator<=>(const timer& a, const timer& b) noexcept = default;
+    };
+
+    explicit event_loop(display& parent) : event_loop{token{}, parent}
+    {
+        if(const auto error = create())
+        {
+            throw std::runtime_error("Failed to create the event loop");
+        }
+    }
+
+    event_loop(const event_loop&)            = delete;
+    event_loop& operator=(const event_loop&) = delete;
+
+    event_loop(event_loop&& other) noexcept
+        : m_display{std::exchange(other.m_display, nullptr)},
+          m_epoll{std::move(other.m_epoll)},
+          m_wake{std::move(other.m_wake)},
+          m_sources{std::exchange(other.m_sources, {})},
+          m_removed{std::exchange(other.m_removed, {})},
+          m_flush_pending{std::exchange(other.m_flush_pending, false)},
+          m_dispatching{std::exchange(other.m_dispatching, false)},
+          m_stop{other.m_stop.exchange(false)}
+    {
+    }
+
+    event_loop& operator=(event_loop&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~event_loop() noexcept = default;
+
+    [[nodiscard]] static std::expected<event_loop, any_call_info> make(display& parent) noexcept
+    {
+        event_loop result = {token{}, parent};
+
+        if(const auto error = result.create())
+        {
+            return std::unexpected{*error};
+        }
+
+        return result;
+    }
+
+    /// Returns the epoll file descriptor. Readable when dispatch has something to do.
+    [[nodiscard]] int fd() const noexcept { return m_epoll.get().value; }
+
+    /// Returns the file descriptor of the display connection.
+    [[nodiscard]] int display_fd() const noexcept { return wl_display_get_fd(m_display); }
+
+    /**
+     * Calls a function when a file descriptor becomes ready. The file descriptor is not owned by the loop.
+     * @param events Epoll events to wait for, EPOLLIN for example.
+     * @returns False if the file descriptor could not be added, for example because it is already watched.
+     */
+    [[nodiscard]] bool watch(int fd, std::uint32_t events, watch_callback callback) noexcept;
+
+    /// Stops watching a file descriptor. May be called from a callback, including the callback of this file descriptor.
+    void unwatch(int fd) noexcept;
+
+    /**
+     * Calls a function after a delay, then every period if it is not null. Timers run on the monotonic clock.
+     * One-shot timers are removed once they fire.
+     */
+    [[nodiscard]] std::optional<timer> add_timer(std::chrono::nanoseconds delay, std::chrono::nanoseconds period, timer_callback callback) noexcept;
+
+    /// Removes a timer. May be called from a callback, including the callback of this timer.
+    void remove(timer t) noexcept { unwatch(t.value); }
+
+    /**
+     * Waits for events and dispatches them: display events first, then timers and watched file descriptors, in the order epoll reports them.
+     * Pending requests are flushed before waiting and after dispatching.
+     * @param timeout How long to wait for an event. Waits indefinitely if not provided, returns immediately if null.
+     * @returns The number of timers and watched file descriptors that fired, or an error if the connection to the display was lost.
+     */
+    [[nodiscard]] std::expected<std::size_t, any_call_info> dispatch(std::optional<std::chrono::milliseconds> timeout = std::nullopt) noexcept;
+
+    /// Dispatches events until stop is called, or until the connection to the display is lost.
+    [[nodiscard]] std::optional<any_call_info> run() noexcept;
+
+    /// Makes run return after the current iteration. Thread-safe.
+    void stop() noexcept;
+
+    /// Interrupts a dispatch waiting for events. Thread-safe.
+    void wake() noexcept;
+
+    void swap(event_loop& other) noexcept
+    {
+        std::swap(m_display, other.m_display);
+        m_epoll.swap(other.m_epoll);
+        m_wake.swap(other.m_wake);
+        m_sources.swap(other.m_sources);
+        m_removed.swap(other.m_removed);
+        std::swap(m_flush_pending, other.m_flush_pending);
+        std::swap(m_dispatching, other.m_dispatching);
+        m_stop.store(other.m_stop.exchange(m_stop.load()));
+    }
+
+    friend void swap(event_loop& a, event_loop& b) noexcept { a.swap(b); }
+
+private:
+
+    struct source
+    {
+        file_descriptor owned    = {};    ///< Set for timers, whose file descriptor belongs to the loop.
+        watch_callback  callback = {};
+        bool            one_shot = false; ///< Removed after its first call.
+        bool            removed  = false; ///< Removed while dispatching, erased once dispatch is done.
+    };
+
+    event_loop(token, display& parent) noexcept : m_display{parent.handle()} {}
+
+    [[nodiscard]] std::optional<any_call_info> create() noexcept;
+
+    /// Flushes pending requests. Watches the display for EPOLLOUT while the socket is full.
+    /// @returns False if the connection to the display was lost.
+    [[nodiscard]] bool flush() noexcept;
+
+    /// Erases the sources removed while dispatching.
+    void collect() noexcept;
+
+    wl_display*                     m_display       = nullptr;
+    file_descriptor                 m_epoll         = {};
+    file_descriptor                 m_wake          = {}; ///< eventfd written to by wake.
+    std::unordered_map<int, source> m_sources       = {}; ///< Timers and watched file descriptors, by file descriptor.
+    std::vector<int>                m_removed       = {};
+    bool                            m_flush_pending = false;
+    bool                            m_dispatching   = false;
+    std::atomic<bool>               m_stop          = false;
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_EVENT_LOOP_HPP
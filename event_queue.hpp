@@ -0,0 +1,144 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_EVENT_QUEUE_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_EVENT_QUEUE_HPP
+
+#include "display.hpp"
+
+#include <expected>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Event queue, with wrappers of the display globals that create their objects on it.
+ * Objects created from globals() receive their events on this queue as soon as they exist, which wl_proxy_set_queue after creation cannot
+ * guarantee while another thread reads the display. The queue is dispatched independently of the default one, possibly on another thread.
+ * Must outlive the objects created from it.
+ */
+class event_queue
+{
+    struct token
+    {
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    explicit event_queue(display& parent) : event_queue{token{}, parent}
+    {
+        if(const auto error = create(parent))
+        {
+            throw std::runtime_error("Failed to create the Wayland event queue");
+        }
+    }
+
+    event_queue(const event_queue&)            = delete;
+    event_queue& operator=(const event_queue&) = delete;
+
+    event_queue(event_queue&& other) noexcept
+        : m_display{std::exchange(other.m_display, nullptr)},
+          m_handle{std::exchange(other.m_handle, nullptr)},
+          m_globals{std::exchange(other.m_globals, display::global{})}
+    {
+    }
+
+    event_queue& operator=(event_queue&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~event_queue() noexcept;
+
+    [[nodiscard]] static std::expected<event_queue, any_call_info> make(display& parent) noexcept
+    {
+        event_queue result = {token{}, parent};
+
+        if(const auto error = result.create(parent))
+        {
+            return std::unexpected{*error};
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] auto*       handle() noexcept { return m_handle; }
+    [[nodiscard]] const auto* handle() const noexcept { return m_handle; }
+
+    /// Returns wrappers of the globals of the parent display. Objects they create are on this queue. Wrappers never receive events.
+    [[nodiscard]] const auto& globals() const noexcept { return m_globals; }
+
+    /// Moves an existing object to this queue. Only race-free if the object cannot have received events yet.
+    void adopt(void* proxy) noexcept { wl_proxy_set_queue(static_cast<wl_proxy*>(proxy), m_handle); }
+
+    /**
+     * Flushes the display, then blocks until events are available for this queue and dispatches them. Reads the display if no other thread
+     * does. The flush is counted by protocol_stats.
+     * @returns The number of dispatched events, or -1 on error.
+     */
+    int dispatch() noexcept;
+
+    /// Dispatches the events already read for this queue, without blocking. @returns The number of dispatched events, or -1 on error.
+    int dispatch_pending() noexcept { return wl_display_dispatch_queue_pending(m_display, m_handle); }
+
+    /// Blocks until the compositor processed every request sent so far, dispatching the events of this queue meanwhile. Counted by protocol_stats.
+    int roundtrip() noexcept;
+
+    void swap(event_queue& other) noexcept
+    {
+        std::swap(m_display, other.m_display);
+        std::swap(m_handle, other.m_handle);
+        m_globals.swap(other.m_globals);
+    }
+
+    friend void swap(event_queue& a, event_queue& b) noexcept { a.swap(b); }
+
+private:
+
+    event_queue(token, display& parent) noexcept : m_display{parent.handle()} {}
+
+    [[nodiscard]] std::optional<any_call_info> create(display& parent) noexcept;
+
+    wl_display*     m_display = nullptr;
+    wl_event_queue* m_handle  = nullptr;
+    display::global m_globals = {}; ///< Wrappers, destroyed with wl_proxy_wrapper_destroy.
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_EVENT_QUEUE_HPP
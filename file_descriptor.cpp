@@ -38,6 +38,54 @@
 namespace fubuki::io::platform::linux_bsd
 {
 
+namespace
+{
+
+/// Sets the size of an empty file.
+[[nodiscard]] bool allocate(int fd, std::size_t size_bytes, file_descriptor::allocation alloc) noexcept
+{
+    if(alloc == file_descriptor::allocation::sparse)
+    {
+        return ftruncate(fd, static_cast<::off_t>(size_bytes)) == 0;
+    }
+
+    // TODO: can get more info through the return code
+    return posix_fallocate(fd, 0, static_cast<::off_t>(size_bytes)) == 0;
+}
+
+#if defined(FUBUKI_HAS_MEMFD_CREATE)
+
+/// Creates a sealed memfd. The seals prevent the compositor from ever seeing the file shrink.
+[[nodiscard]] std::optional<file_descriptor> make_memfd(unsigned int flags, std::size_t size_bytes, file_descriptor::allocation alloc) noexcept
+{
+    const int fd = memfd_create("fubuki-io-platform-linux", MFD_CLOEXEC | MFD_ALLOW_SEALING | flags);
+
+    if(fd < 0)
+    {
+        return std::nullopt;
+    }
+
+    file_descriptor result{file_descriptor::handle{fd}};
+
+    // Works because the file is currently empty, before we call allocate
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+    if(fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) == -1)
+    {
+        return std::nullopt;
+    }
+
+    if(not allocate(fd, size_bytes, alloc))
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+#endif // defined(FUBUKI_HAS_MEMFD_CREATE)
+
+} // namespace
+
 file_descriptor::~file_descriptor() noexcept
 {
     if(m_handle.has_value())
@@ -47,7 +95,7 @@ file_descriptor::~file_descriptor() noexcept
 }
 
 [[nodiscard]] auto file_descriptor::make_anonymous(
-    std::size_t size_bytes, std::string_view fallback_path, std::string_view fallback_name_template, anonymous_hint hint) noexcept
+    std::size_t size_bytes, std::string_view fallback_path, std::string_view fallback_name_template, anonymous_hint hint, allocation alloc) noexcept
     -> std::expected<file_descriptor, create_error>
 {
     const auto fall_back = [&]() noexcept -> std::expected<file_descriptor, create_error>
@@ -63,9 +111,8 @@ file_descriptor::~file_descriptor() noexcept
 
             unlink(full_path.c_str());
 
-            if(posix_fallocate(result.m_handle->value, 0, static_cast<::off_t>(size_bytes)) != 0)
+            if(not allocate(fd, size_bytes, alloc))
             {
-                // TODO: can get more info through the return code
                 return std::unexpected{create_error{}};
             }
             return result;
@@ -78,31 +125,32 @@ file_descriptor::~file_descriptor() noexcept
 
     if(hint == anonymous_hint::memfd)
     {
-        if(int const fd = memfd_create("fubuki-io-platform-linux", MFD_CLOEXEC | MFD_ALLOW_SEALING); fd >= 0)
+        if(auto result = make_memfd(0, size_bytes, alloc))
         {
-            file_descriptor result{handle{fd}};
-
-            // Works because the file is currently empty, before we call posix_fallocate
-            // NOLINTNEXTLINE(bugprone-unchecked-optional-access, cppcoreguidelines-pro-type-vararg)
-            if(fcntl(result.m_handle->value, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) == -1)
-            {
-                return std::unexpected{create_error{}};
-            }
+            return *std::move(result);
+        }
 
-            if(posix_fallocate(result.m_handle->value, 0, static_cast<::off_t>(size_bytes)) != 0)
-            {
-                // TODO: can get more info through the return code
-                return std::unexpected{create_error{}};
-            }
+        return fall_back();
+    }
 
-            return result;
+    if(hint == anonymous_hint::memfd_hugetlb)
+    {
+        // Huge pages come from a reserved pool: without posix_fallocate, running out of them would only show up as SIGBUS on first write
+        if(auto result = make_memfd(MFD_HUGETLB, size_bytes, allocation::reserve))
+        {
+            return *std::move(result);
         }
 
-        return fall_back();
+        return std::unexpected{create_error{}};
     }
 
 #endif // defined(FUBUKI_HAS_MEMFD_CREATE)
 
+    if(hint == anonymous_hint::memfd_hugetlb)
+    {
+        return std::unexpected{create_error{}};
+    }
+
     return fall_back();
 }
 
@@ -50,8 +50,16 @@ public:
     /// Hints for make_anonymous
     enum class anonymous_hint
     {
-        memfd,    ///< Prefer memfd_create. If not available or if the call failed, fallback to the arguments provided to make_anonymous.
-        provided, ///< Directly use the arguments provided to make_anonymous.
+        memfd,         ///< Prefer memfd_create. If not available or if the call failed, fallback to the arguments provided to make_anonymous.
+        provided,      ///< Directly use the arguments provided to make_anonymous.
+        memfd_hugetlb, ///< Use memfd_create with MFD_HUGETLB. Does not fall back. The size must be a multiple of the default huge page size.
+    };
+
+    /// How make_anonymous allocates the storage of the file.
+    enum class allocation
+    {
+        reserve, ///< Allocate every block upfront with posix_fallocate, so that running out of memory is reported by make_anonymous.
+        sparse,  ///< Only set the size of the file. Blocks are allocated on first write, which raises SIGBUS if memory runs out.
     };
 
     /// File descriptor handle.
@@ -90,6 +98,9 @@ public:
     /// Destructor. Closes the underlying file descriptor handle.
     ~file_descriptor() noexcept;
 
+    /// Returns true if this object owns a file descriptor.
+    [[nodiscard]] bool valid() const noexcept { return m_handle.has_value(); }
+
     /// Returns the handle this object currently owns.
     /// If no file descriptor is owned by this object (after std::move, for example), the behaviour is undefined.
     [[nodiscard]] handle get() const noexcept
@@ -105,11 +116,13 @@ public:
      * @param fallback_name_template The name template for the file, when memfd_create failed or when the hint is anonymous_hint::provided. If the
      * name does not end by "-XXXXXX", this is appended.
      * @param hint Hint for arguments usage. @see fubuki::io::platform::linux::anonymous_hint
+     * @param alloc How the storage of the file is allocated. Files backed by huge pages are always reserved.
      */
     [[nodiscard]] static std::expected<file_descriptor, create_error> make_anonymous(std::size_t      size_bytes,
                                                                                      std::string_view fallback_path,
                                                                                      std::string_view fallback_name_template,
-                                                                                     anonymous_hint   hint = {}) noexcept;
+                                                                                     anonymous_hint   hint  = {},
+                                                                                     allocation       alloc = {}) noexcept;
 
     /// Swaps two objects.
     void swap(file_descriptor& other) noexcept { m_handle.swap(other.m_handle); }
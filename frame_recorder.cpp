@@ -0,0 +1,128 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "frame_recorder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+[[nodiscard]] frame_recorder::summary summarise(const frame_recorder::histogram& h) noexcept
+{
+    return {
+        .count = h.count(),
+        .p50   = h.percentile(50),
+        .p95   = h.percentile(95),
+        .p99   = h.percentile(99),
+        .max   = h.max(),
+        .mean  = h.mean(),
+    };
+}
+
+} // namespace
+
+void frame_recorder::histogram::add(std::chrono::nanoseconds d) noexcept
+{
+    d = std::max(d, std::chrono::nanoseconds{});
+
+    const auto bucket = static_cast<std::size_t>(d / bucket_width);
+    ++m_buckets[std::min(bucket, bucket_count - 1)];
+
+    ++m_count;
+    m_total += d;
+    m_max = std::max(m_max, d);
+}
+
+std::chrono::nanoseconds frame_recorder::histogram::percentile(double p) const noexcept
+{
+    if(m_count == 0)
+    {
+        return {};
+    }
+
+    // Nearest rank
+    const auto rank = std::clamp(static_cast<std::uint64_t>(std::ceil(p / 100. * static_cast<double>(m_count))), std::uint64_t{1}, m_count);
+
+    std::uint64_t seen = 0;
+
+    for(std::size_t i = 0; i < bucket_count; ++i)
+    {
+        seen += m_buckets[i];
+
+        if(seen >= rank)
+        {
+            return std::min<std::chrono::nanoseconds>(bucket_width * static_cast<std::int64_t>(i + 1), m_max);
+        }
+    }
+
+    return m_max;
+}
+
+void frame_recorder::commit() noexcept
+{
+    const auto now = clock::now();
+
+    if(m_frame_start)
+    {
+        const auto render = now - *m_frame_start;
+
+        m_render.add(render);
+        ++m_frames;
+
+        if(render > m_stall_threshold)
+        {
+            ++m_stalls;
+        }
+
+        m_frame_start = std::nullopt;
+    }
+
+    if(m_last_commit)
+    {
+        m_interval.add(now - *m_last_commit);
+    }
+
+    m_last_commit = now;
+}
+
+auto frame_recorder::stats() const noexcept -> statistics
+{
+    return {
+        .frames   = m_frames,
+        .stalls   = m_stalls,
+        .render   = summarise(m_render),
+        .interval = summarise(m_interval),
+    };
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
@@ -0,0 +1,172 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_FRAME_RECORDER_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_FRAME_RECORDER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Records how long the frames of a surface take to render, from the start of a redraw to the wl_surface.commit sending it, and the
+ * interval between consecutive commits. Durations are kept in fixed histograms, so that recording never allocates and costs a few
+ * additions. Idle periods show up as long intervals: reset the recorder before a sequence of frames to measure only its pacing.
+ */
+class frame_recorder
+{
+public:
+
+    using clock = std::chrono::steady_clock;
+
+    /// Width of the buckets of the histograms.
+    static constexpr std::chrono::microseconds bucket_width{100};
+
+    /// Number of buckets of the histograms. The last bucket also counts every longer duration.
+    static constexpr std::size_t bucket_count = 512;
+
+    /// Frames rendering for longer than this are counted as stalls: a refresh at 60 Hz.
+    static constexpr std::chrono::nanoseconds default_stall_threshold = std::chrono::microseconds{16'667};
+
+    /// Distribution of durations. Percentiles are read from the buckets: they are exact to a bucket width, and never exceed the maximum.
+    class histogram
+    {
+    public:
+
+        void add(std::chrono::nanoseconds d) noexcept;
+
+        /// Returns the upper bound of the bucket the p-th percentile falls in, p being in [0, 100]. Zero if nothing was recorded.
+        [[nodiscard]] std::chrono::nanoseconds percentile(double p) const noexcept;
+
+        [[nodiscard]] std::uint64_t count() const noexcept { return m_count; }
+
+        [[nodiscard]] std::chrono::nanoseconds max() const noexcept { return m_max; }
+
+        [[nodiscard]] std::chrono::nanoseconds mean() const noexcept
+        {
+            return (m_count == 0) ? std::chrono::nanoseconds{} : m_total / static_cast<std::int64_t>(m_count);
+        }
+
+        [[nodiscard]] const auto& buckets() const noexcept { return m_buckets; }
+
+    private:
+
+        std::array<std::uint32_t, bucket_count> m_buckets = {};
+        std::uint64_t                           m_count   = 0;
+        std::chrono::nanoseconds                m_total   = {};
+        std::chrono::nanoseconds                m_max     = {};
+    };
+
+    /// Percentiles of a histogram.
+    struct summary
+    {
+        std::uint64_t            count = 0;
+        std::chrono::nanoseconds p50   = {};
+        std::chrono::nanoseconds p95   = {};
+        std::chrono::nanoseconds p99   = {};
+        std::chrono::nanoseconds max   = {};
+        std::chrono::nanoseconds mean  = {};
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const summary& s)
+        {
+            using ms = std::chrono::duration<double, std::milli>;
+
+            return out << "{count: " << s.count << ", p50: " << ms{s.p50}.count() << ", p95: " << ms{s.p95}.count()
+                       << ", p99: " << ms{s.p99}.count() << ", max: " << ms{s.max}.count() << ", mean: " << ms{s.mean}.count() << "}";
+        }
+    };
+
+    struct statistics
+    {
+        std::uint64_t frames   = 0;  ///< Frames committed.
+        std::uint64_t stalls   = 0;  ///< Frames that rendered for longer than the stall threshold.
+        summary       render   = {}; ///< From the start of a redraw to the commit sending it.
+        summary       interval = {}; ///< Between consecutive commits, with or without a new frame.
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const statistics& s)
+        {
+            return out << "frames:{frames: " << s.frames << ", stalls: " << s.stalls << ", render (ms): " << s.render
+                       << ", interval (ms): " << s.interval << "}";
+        }
+    };
+
+    /// Constructor. @param stall_threshold Frames rendering for longer than this are counted as stalls.
+    explicit frame_recorder(std::chrono::nanoseconds stall_threshold = default_stall_threshold) noexcept
+        : m_stall_threshold{stall_threshold}
+    {
+    }
+
+    /// Marks the start of the rendering of a frame. Must be followed by commit once the frame is attached.
+    void begin_frame() noexcept { m_frame_start = clock::now(); }
+
+    /// Records a wl_surface.commit. Must be called right before it. Completes the frame begun, if any.
+    void commit() noexcept;
+
+    /// Forgets every recorded duration. A frame begun is still completed by the next commit.
+    void reset() noexcept
+    {
+        m_render      = {};
+        m_interval    = {};
+        m_frames      = 0;
+        m_stalls      = 0;
+        m_last_commit = std::nullopt;
+    }
+
+    void set_stall_threshold(std::chrono::nanoseconds t) noexcept { m_stall_threshold = t; }
+
+    [[nodiscard]] auto stall_threshold() const noexcept { return m_stall_threshold; }
+
+    [[nodiscard]] const histogram& render_times() const noexcept { return m_render; }
+
+    [[nodiscard]] const histogram& intervals() const noexcept { return m_interval; }
+
+    /// Computes the percentiles of the histograms. Reads a few kilobytes, and does not allocate.
+    [[nodiscard]] statistics stats() const noexcept;
+
+private:
+
+    histogram                        m_render          = {};
+    histogram                        m_interval        = {};
+    std::uint64_t                    m_frames          = 0;
+    std::uint64_t                    m_stalls          = 0;
+    std::chrono::nanoseconds         m_stall_threshold = default_stall_threshold;
+    std::optional<clock::time_point> m_frame_start     = {}; ///< Start of the frame being rendered, if any.
+    std::optional<clock::time_point> m_last_commit     = {};
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_FRAME_RECORDER_HPP
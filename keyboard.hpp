@@ -30,6 +30,7 @@
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_KEYBOARD_HPP
 
 #include "display.hpp"
+#include "protocol_stats.hpp"
 
 namespace fubuki::io::platform::linux_bsd::wayland
 {
@@ -46,9 +47,12 @@ public:
     {
     };
 
-    keyboard(display& parent)
+    keyboard(display& parent) : keyboard{parent.globals()} {}
+
+    /// Constructor. Creates the keyboard from the seat of a set of globals, event_queue::globals for example.
+    explicit keyboard(const display::global& globals)
     {
-        if(const auto error = create(parent))
+        if(const auto error = create(globals))
         {
             throw std::runtime_error("");
         }
@@ -73,11 +77,13 @@ public:
         }
     }
 
-    [[nodiscard]] static std::expected<keyboard, any_call_info> make(display& parent) noexcept
+    [[nodiscard]] static std::expected<keyboard, any_call_info> make(display& parent) noexcept { return make(parent.globals()); }
+
+    [[nodiscard]] static std::expected<keyboard, any_call_info> make(const display::global& globals) noexcept
     {
         keyboard result = {token{}};
 
-        if(const auto error = result.create(parent))
+        if(const auto error = result.create(globals))
         {
             return std::unexpected{*error};
         }
@@ -96,14 +102,14 @@ private:
 
     keyboard(token) noexcept {}
 
-    [[nodiscard]] std::optional<any_call_info> create(display& parent) noexcept
+    [[nodiscard]] std::optional<any_call_info> create(const display::global& globals) noexcept
     {
-        if(parent.globals().seat == nullptr)
+        if(globals.seat == nullptr)
         {
             return any_call_info{};
         }
 
-        m_handle = wl_seat_get_keyboard(parent.globals().seat);
+        m_handle = protocol_stats::send<WL_SEAT_GET_KEYBOARD>(wl_seat_get_keyboard, globals.seat);
 
         if(m_handle == nullptr)
         {
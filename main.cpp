@@ -1,3 +1,4 @@
+#include "bench.hpp"
 #include "file_descriptor.hpp"
 #include "test.hpp"
 
@@ -46,11 +47,70 @@ int main()
     //     return *x;
     // }
 
+    if(const auto x = run("opacity kernels", sandbox::wayland::bench::opacity))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("clear kernels", sandbox::wayland::bench::clear))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("canvas primitives", sandbox::wayland::bench::canvas))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("tile renderer", sandbox::wayland::bench::tiles))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("shm_pool backing", sandbox::wayland::bench::backing))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("swapchain prefault", sandbox::wayland::bench::prefault))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("startup", sandbox::wayland::bench::startup))
+    {
+        return *x;
+    }
+
     if(const auto x = run("shm_buffer", sandbox::wayland::shm_buffer))
     {
         return *x;
     }
 
+    if(const auto x = run("shm_arena", sandbox::wayland::shm_arena))
+    {
+        return *x;
+    }
+
+#if defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
+    if(const auto x = run("mock compositor", sandbox::wayland::mock_compositor))
+    {
+        return *x;
+    }
+
+    if(const auto x = run("mock windows", sandbox::wayland::mock_windows))
+    {
+        return *x;
+    }
+
+#endif // defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
+    if(const auto x = run("async windows", sandbox::wayland::async_windows))
+    {
+        return *x;
+    }
+
     if(const auto x = run("window", sandbox::wayland::window))
     {
         return *x;
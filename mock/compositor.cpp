@@ -0,0 +1,1178 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "compositor.hpp"
+#include "../file_descriptor.hpp"
+#include "../xdg/generated/shell-server-protocol.hpp"
+#include "../zxdg/generated/decoration-server-protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <wayland-server.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland::mock
+{
+
+namespace
+{
+
+/// Versions advertised, unless libwayland or the generated code describes an older one. The implementations below handle every request
+/// up to these versions.
+constexpr std::uint32_t compositor_v = 4;
+constexpr std::uint32_t shm_v        = 1;
+constexpr std::uint32_t output_v     = 4;
+constexpr std::uint32_t seat_v       = 5;
+constexpr std::uint32_t wm_base_v    = 6;
+constexpr std::uint32_t decoration_v = 1;
+
+[[nodiscard]] int advertised(const wl_interface& i, std::uint32_t ours) noexcept
+{
+    return std::min(i.version, static_cast<int>(ours));
+}
+
+struct server;
+struct surface;
+
+/// Buffer attached to a surface, and forgotten if the client destroys it before committing.
+struct buffer_reference
+{
+    wl_listener  destroyed = {}; ///< First member: the listener is converted back to its reference.
+    surface*     owner     = nullptr;
+    wl_resource* buffer    = nullptr;
+};
+
+struct surface
+{
+    server*          owner    = nullptr;
+    buffer_reference attached = {};
+    wl_resource*     role     = nullptr; ///< xdg_surface, if any.
+    wl_resource*     toplevel = nullptr; ///< xdg_toplevel, if any.
+
+    std::size_t next_configure = 0;     ///< Index of the next size of script::configures.
+    bool        initial        = true;  ///< True until the initial commit, which the first configure event answers.
+    bool        acked          = false; ///< True once the last configure event was acknowledged.
+};
+
+struct output
+{
+    output_info               info      = {};
+    wl_global*                global    = nullptr;
+    std::vector<wl_resource*> resources = {}; ///< Bound by clients. Their user data is reset when the output is unplugged.
+};
+
+/// Frame request, answered by the next tick once its surface is committed.
+struct frame_request
+{
+    wl_resource* callback  = nullptr;
+    surface*     target    = nullptr; ///< Null once the surface is destroyed.
+    bool         committed = false;
+};
+
+/// Counts connecting clients.
+struct client_listener
+{
+    wl_listener created = {}; ///< First member: the listener is converted back to this object.
+    server*     owner   = nullptr;
+};
+
+struct server
+{
+    script config = {};
+
+    wl_display*      display     = nullptr;
+    wl_event_loop*   loop        = nullptr;
+    wl_event_source* wake_source = nullptr;
+    wl_event_source* frame_timer = nullptr;
+    std::string      socket      = {}; ///< Absolute path of the socket, removed with the compositor.
+    std::string      directory   = {}; ///< Temporary directory holding the socket, removed with the compositor.
+    file_descriptor  wake        = {}; ///< eventfd, written to run commands or stop.
+    client_listener  clients     = {};
+
+    std::vector<std::unique_ptr<output>> outputs = {};
+    std::vector<frame_request>           frames  = {};
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::atomic<bool>         stop       = false;
+    std::atomic<std::int64_t> latency_ns = 0;
+
+    std::mutex                                mutex    = {};
+    std::vector<std::function<void(server&)>> commands = {}; ///< Run by the compositor thread.
+
+    struct
+    {
+        std::atomic<std::size_t> clients    = 0;
+        std::atomic<std::size_t> surfaces   = 0;
+        std::atomic<std::size_t> buffers    = 0;
+        std::atomic<std::size_t> commits    = 0;
+        std::atomic<std::size_t> configures = 0;
+        std::atomic<std::size_t> frames     = 0;
+    } counters;
+
+    std::thread thread = {};
+
+    void run() noexcept;
+    void post(std::function<void(server&)> command);
+    void add_output(output_info info);
+    void remove_output(std::string_view name);
+    void send_frames() noexcept;
+    void commit(surface& s) noexcept;
+    void send_configure(surface& s) noexcept;
+};
+
+template<typename T>
+[[nodiscard]] T* data_of(wl_resource* r) noexcept
+{
+    return static_cast<T*>(wl_resource_get_user_data(r));
+}
+
+/// Creates the resource of a request, with the version of the object it is created from. Reports running out of memory to the client.
+[[nodiscard]] wl_resource* create(wl_client* client, const wl_interface& i, wl_resource* parent, std::uint32_t id) noexcept
+{
+    wl_resource* const r = wl_resource_create(client, &i, wl_resource_get_version(parent), id);
+
+    if(r == nullptr)
+    {
+        wl_client_post_no_memory(client);
+    }
+
+    return r;
+}
+
+void detach(buffer_reference& ref) noexcept
+{
+    if(ref.buffer != nullptr)
+    {
+        wl_list_remove(&ref.destroyed.link);
+        ref.buffer = nullptr;
+    }
+}
+
+namespace callback
+{
+
+/// Requests the compositor has nothing to do about.
+template<typename... arguments>
+void ignore(wl_client* /*client*/, wl_resource* /*resource*/, arguments... /*args*/) noexcept
+{
+}
+
+void destroy(wl_client* /*client*/, wl_resource* resource) noexcept { wl_resource_destroy(resource); }
+
+void buffer_destroyed(wl_listener* listener, void* /*data*/) noexcept
+{
+    auto* const ref = reinterpret_cast<buffer_reference*>(listener);
+
+    wl_list_remove(&listener->link);
+    ref->buffer = nullptr;
+}
+
+void client_created(wl_listener* listener, void* /*client*/) noexcept { ++reinterpret_cast<client_listener*>(listener)->owner->counters.clients; }
+
+int wake(int fd, std::uint32_t /*mask*/, void* data) noexcept
+{
+    auto* const srv = static_cast<server*>(data);
+
+    std::uint64_t value = 0;
+    std::ignore         = read(fd, &value, sizeof(value));
+
+    std::vector<std::function<void(server&)>> commands;
+
+    {
+        const std::scoped_lock lock{srv->mutex};
+        commands.swap(srv->commands);
+    }
+
+    for(const auto& c : commands)
+    {
+        c(*srv);
+    }
+
+    return 0;
+}
+
+int tick(void* data) noexcept
+{
+    auto* const srv = static_cast<server*>(data);
+
+    srv->send_frames();
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(srv->config.frame_interval).count();
+    wl_event_source_timer_update(srv->frame_timer, static_cast<int>(std::max<std::int64_t>(ms, 1)));
+
+    return 0;
+}
+
+namespace resource
+{
+
+void surface_destroyed(wl_resource* r) noexcept
+{
+    auto* const s = data_of<mock::surface>(r);
+
+    for(auto& f : s->owner->frames)
+    {
+        if(f.target == s)
+        {
+            f.target = nullptr;
+        }
+    }
+
+    for(auto* const role : {s->role, s->toplevel})
+    {
+        if(role != nullptr)
+        {
+            wl_resource_set_user_data(role, nullptr);
+        }
+    }
+
+    detach(s->attached);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete s;
+}
+
+void frame_destroyed(wl_resource* r) noexcept
+{
+    std::erase_if(data_of<server>(r)->frames, [r](const frame_request& f) { return f.callback == r; });
+}
+
+void output_unbound(wl_resource* r) noexcept
+{
+    if(auto* const o = data_of<output>(r))
+    {
+        std::erase(o->resources, r);
+    }
+}
+
+void xdg_surface_destroyed(wl_resource* r) noexcept
+{
+    if(auto* const s = data_of<mock::surface>(r))
+    {
+        s->role = nullptr;
+    }
+}
+
+void toplevel_destroyed(wl_resource* r) noexcept
+{
+    if(auto* const s = data_of<mock::surface>(r))
+    {
+        s->toplevel = nullptr;
+    }
+}
+
+} // namespace resource
+
+namespace surface
+{
+
+void attach(wl_client* /*client*/, wl_resource* resource, wl_resource* buffer, std::int32_t /*x*/, std::int32_t /*y*/) noexcept
+{
+    auto& ref = data_of<mock::surface>(resource)->attached;
+
+    detach(ref);
+
+    if(buffer != nullptr)
+    {
+        ref.buffer           = buffer;
+        ref.destroyed.notify = buffer_destroyed;
+        wl_resource_add_destroy_listener(buffer, &ref.destroyed);
+    }
+}
+
+void frame(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    auto* const s = data_of<mock::surface>(resource);
+
+    wl_resource* const callback = wl_resource_create(client, &wl_callback_interface, 1, id);
+
+    if(callback == nullptr)
+    {
+        wl_client_post_no_memory(client);
+        return;
+    }
+
+    wl_resource_set_implementation(callback, nullptr, s->owner, resource::frame_destroyed);
+    s->owner->frames.push_back({.callback = callback, .target = s});
+}
+
+void commit(wl_client* /*client*/, wl_resource* resource) noexcept
+{
+    auto* const s = data_of<mock::surface>(resource);
+    s->owner->commit(*s);
+}
+
+} // namespace surface
+
+namespace compositor
+{
+
+void create_surface(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+
+void create_region(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+
+} // namespace compositor
+
+namespace shm
+{
+
+void create_buffer(wl_client* client,
+                   wl_resource* resource,
+                   std::uint32_t id,
+                   std::int32_t /*offset*/,
+                   std::int32_t /*width*/,
+                   std::int32_t /*height*/,
+                   std::int32_t /*stride*/,
+                   std::uint32_t /*format*/) noexcept;
+
+void create_pool(wl_client* client, wl_resource* resource, std::uint32_t id, std::int32_t fd, std::int32_t /*size*/) noexcept;
+
+} // namespace shm
+
+namespace seat
+{
+
+void get_pointer(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+void get_keyboard(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+void get_touch(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+
+} // namespace seat
+
+namespace xdg
+{
+
+void create_positioner(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+void get_xdg_surface(wl_client* client, wl_resource* resource, std::uint32_t id, wl_resource* wl_surface) noexcept;
+void get_toplevel(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept;
+
+void get_popup(wl_client* /*client*/, wl_resource* resource, std::uint32_t /*id*/, wl_resource* /*parent*/, wl_resource* /*positioner*/) noexcept
+{
+    wl_resource_post_error(resource, WL_DISPLAY_ERROR_INVALID_METHOD, "popups are not supported by the mock compositor");
+}
+
+void ack_configure(wl_client* /*client*/, wl_resource* resource, std::uint32_t /*serial*/) noexcept
+{
+    if(auto* const s = data_of<mock::surface>(resource))
+    {
+        s->acked = true;
+    }
+}
+
+// Validated like a real compositor would, rather than ignored: a zero size is a client bug
+void set_window_geometry(
+    wl_client* /*client*/, wl_resource* resource, std::int32_t /*x*/, std::int32_t /*y*/, std::int32_t width, std::int32_t height) noexcept
+{
+    if(width <= 0 or height <= 0)
+    {
+        wl_resource_post_error(resource, XDG_SURFACE_ERROR_INVALID_SIZE, "window geometry of %dx%d", width, height);
+    }
+}
+
+} // namespace xdg
+
+namespace decoration
+{
+
+void get_toplevel_decoration(wl_client* client, wl_resource* resource, std::uint32_t id, wl_resource* /*toplevel*/) noexcept;
+
+void set_mode(wl_client* /*client*/, wl_resource* resource, std::uint32_t /*mode*/) noexcept
+{
+    const bool server_side = data_of<server>(resource)->config.server_side_decorations;
+
+    zxdg_toplevel_decoration_v1_send_configure(resource,
+                                               server_side ? ZXDG_TOPLEVEL_DECORATION_V1_MODE_SERVER_SIDE
+                                                           : ZXDG_TOPLEVEL_DECORATION_V1_MODE_CLIENT_SIDE);
+}
+
+void unset_mode(wl_client* client, wl_resource* resource) noexcept { set_mode(client, resource, 0); }
+
+} // namespace decoration
+
+} // namespace callback
+
+namespace implementation
+{
+
+constexpr struct wl_compositor_interface compositor = {
+    .create_surface = callback::compositor::create_surface,
+    .create_region  = callback::compositor::create_region,
+};
+
+constexpr struct wl_region_interface region = {
+    .destroy  = callback::destroy,
+    .add      = callback::ignore<std::int32_t, std::int32_t, std::int32_t, std::int32_t>,
+    .subtract = callback::ignore<std::int32_t, std::int32_t, std::int32_t, std::int32_t>,
+};
+
+constexpr struct wl_surface_interface surface = {
+    .destroy              = callback::destroy,
+    .attach               = callback::surface::attach,
+    .damage               = callback::ignore<std::int32_t, std::int32_t, std::int32_t, std::int32_t>,
+    .frame                = callback::surface::frame,
+    .set_opaque_region    = callback::ignore<wl_resource*>,
+    .set_input_region     = callback::ignore<wl_resource*>,
+    .commit               = callback::surface::commit,
+    .set_buffer_transform = callback::ignore<std::int32_t>,
+    .set_buffer_scale     = callback::ignore<std::int32_t>,
+    .damage_buffer        = callback::ignore<std::int32_t, std::int32_t, std::int32_t, std::int32_t>,
+};
+
+constexpr struct wl_shm_interface shm = {
+    .create_pool = callback::shm::create_pool,
+};
+
+constexpr struct wl_shm_pool_interface shm_pool = {
+    .create_buffer = callback::shm::create_buffer,
+    .destroy       = callback::destroy,
+    .resize        = callback::ignore<std::int32_t>,
+};
+
+constexpr struct wl_buffer_interface buffer = {
+    .destroy = callback::destroy,
+};
+
+constexpr struct wl_output_interface output = {
+    .release = callback::destroy,
+};
+
+constexpr struct wl_seat_interface seat = {
+    .get_pointer  = callback::seat::get_pointer,
+    .get_keyboard = callback::seat::get_keyboard,
+    .get_touch    = callback::seat::get_touch,
+    .release      = callback::destroy,
+};
+
+constexpr struct wl_pointer_interface pointer = {
+    .set_cursor = callback::ignore<std::uint32_t, wl_resource*, std::int32_t, std::int32_t>,
+    .release    = callback::destroy,
+};
+
+constexpr struct wl_keyboard_interface keyboard = {
+    .release = callback::destroy,
+};
+
+constexpr struct wl_touch_interface touch = {
+    .release = callback::destroy,
+};
+
+constexpr struct xdg_wm_base_interface wm_base = {
+    .destroy           = callback::destroy,
+    .create_positioner = callback::xdg::create_positioner,
+    .get_xdg_surface   = callback::xdg::get_xdg_surface,
+    .pong              = callback::ignore<std::uint32_t>,
+};
+
+// Positioners only serve popups, which are not supported
+constexpr struct xdg_positioner_interface positioner = {
+    .destroy                   = callback::destroy,
+    .set_size                  = callback::ignore<std::int32_t, std::int32_t>,
+    .set_anchor_rect           = callback::ignore<std::int32_t, std::int32_t, std::int32_t, std::int32_t>,
+    .set_anchor                = callback::ignore<std::uint32_t>,
+    .set_gravity               = callback::ignore<std::uint32_t>,
+    .set_constraint_adjustment = callback::ignore<std::uint32_t>,
+    .set_offset                = callback::ignore<std::int32_t, std::int32_t>,
+    .set_reactive              = callback::ignore<>,
+    .set_parent_size           = callback::ignore<std::int32_t, std::int32_t>,
+    .set_parent_configure      = callback::ignore<std::uint32_t>,
+};
+
+constexpr struct xdg_surface_interface xdg_surface = {
+    .destroy             = callback::destroy,
+    .get_toplevel        = callback::xdg::get_toplevel,
+    .get_popup           = callback::xdg::get_popup,
+    .set_window_geometry = callback::xdg::set_window_geometry,
+    .ack_configure       = callback::xdg::ack_configure,
+};
+
+constexpr struct xdg_toplevel_interface toplevel = {
+    .destroy          = callback::destroy,
+    .set_parent       = callback::ignore<wl_resource*>,
+    .set_title        = callback::ignore<const char*>,
+    .set_app_id       = callback::ignore<const char*>,
+    .show_window_menu = callback::ignore<wl_resource*, std::uint32_t, std::int32_t, std::int32_t>,
+    .move             = callback::ignore<wl_resource*, std::uint32_t>,
+    .resize           = callback::ignore<wl_resource*, std::uint32_t, std::uint32_t>,
+    .set_max_size     = callback::ignore<std::int32_t, std::int32_t>,
+    .set_min_size     = callback::ignore<std::int32_t, std::int32_t>,
+    .set_maximized    = callback::ignore<>,
+    .unset_maximized  = callback::ignore<>,
+    .set_fullscreen   = callback::ignore<wl_resource*>,
+    .unset_fullscreen = callback::ignore<>,
+    .set_minimized    = callback::ignore<>,
+};
+
+constexpr struct zxdg_decoration_manager_v1_interface decoration_manager = {
+    .destroy                 = callback::destroy,
+    .get_toplevel_decoration = callback::decoration::get_toplevel_decoration,
+};
+
+constexpr struct zxdg_toplevel_decoration_v1_interface decoration = {
+    .destroy    = callback::destroy,
+    .set_mode   = callback::decoration::set_mode,
+    .unset_mode = callback::decoration::unset_mode,
+};
+
+} // namespace implementation
+
+namespace callback
+{
+
+void compositor::create_surface(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    auto* const srv = data_of<server>(resource);
+
+    wl_resource* const r = create(client, wl_surface_interface, resource, id);
+
+    if(r == nullptr)
+    {
+        return;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    auto* const s = new mock::surface{.owner = srv, .attached = {}};
+    s->attached.owner = s;
+
+    wl_resource_set_implementation(r, std::addressof(implementation::surface), s, resource::surface_destroyed);
+    ++srv->counters.surfaces;
+}
+
+void compositor::create_region(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_region_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::region), nullptr, nullptr);
+    }
+}
+
+void shm::create_pool(wl_client* client, wl_resource* resource, std::uint32_t id, std::int32_t fd, std::int32_t /*size*/) noexcept
+{
+    // Buffers are never read
+    close(fd);
+
+    if(wl_resource* const r = create(client, wl_shm_pool_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::shm_pool), wl_resource_get_user_data(resource), nullptr);
+    }
+}
+
+void shm::create_buffer(wl_client*    client,
+                        wl_resource*  resource,
+                        std::uint32_t id,
+                        std::int32_t /*offset*/,
+                        std::int32_t /*width*/,
+                        std::int32_t /*height*/,
+                        std::int32_t /*stride*/,
+                        std::uint32_t /*format*/) noexcept
+{
+    if(wl_resource* const r = wl_resource_create(client, &wl_buffer_interface, 1, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::buffer), nullptr, nullptr);
+        ++data_of<server>(resource)->counters.buffers;
+    }
+    else
+    {
+        wl_client_post_no_memory(client);
+    }
+}
+
+void seat::get_pointer(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_pointer_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::pointer), nullptr, nullptr);
+    }
+}
+
+void seat::get_keyboard(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_keyboard_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::keyboard), nullptr, nullptr);
+    }
+}
+
+void seat::get_touch(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_touch_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::touch), nullptr, nullptr);
+    }
+}
+
+void xdg::create_positioner(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, xdg_positioner_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::positioner), nullptr, nullptr);
+    }
+}
+
+void xdg::get_xdg_surface(wl_client* client, wl_resource* resource, std::uint32_t id, wl_resource* wl_surface) noexcept
+{
+    auto* const s = data_of<mock::surface>(wl_surface);
+
+    if(wl_resource* const r = create(client, xdg_surface_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::xdg_surface), s, resource::xdg_surface_destroyed);
+        s->role = r;
+    }
+}
+
+void xdg::get_toplevel(wl_client* client, wl_resource* resource, std::uint32_t id) noexcept
+{
+    auto* const s = data_of<mock::surface>(resource);
+
+    if(wl_resource* const r = create(client, xdg_toplevel_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::toplevel), s, resource::toplevel_destroyed);
+
+        if(s != nullptr)
+        {
+            s->toplevel = r;
+        }
+    }
+}
+
+void decoration::get_toplevel_decoration(wl_client* client, wl_resource* resource, std::uint32_t id, wl_resource* /*toplevel*/) noexcept
+{
+    if(wl_resource* const r = create(client, zxdg_toplevel_decoration_v1_interface, resource, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::decoration), wl_resource_get_user_data(resource), nullptr);
+    }
+}
+
+} // namespace callback
+
+namespace bind
+{
+
+/// Creates the resource of a global, or reports running out of memory to the client.
+[[nodiscard]] wl_resource* create(wl_client* client, const wl_interface& i, std::uint32_t version, std::uint32_t id) noexcept
+{
+    wl_resource* const r = wl_resource_create(client, &i, static_cast<int>(version), id);
+
+    if(r == nullptr)
+    {
+        wl_client_post_no_memory(client);
+    }
+
+    return r;
+}
+
+void compositor(wl_client* client, void* data, std::uint32_t version, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_compositor_interface, version, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::compositor), data, nullptr);
+    }
+}
+
+void shm(wl_client* client, void* data, std::uint32_t version, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_shm_interface, version, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::shm), data, nullptr);
+        wl_shm_send_format(r, WL_SHM_FORMAT_ARGB8888);
+        wl_shm_send_format(r, WL_SHM_FORMAT_XRGB8888);
+    }
+}
+
+void output(wl_client* client, void* data, std::uint32_t version, std::uint32_t id) noexcept
+{
+    auto* const o = static_cast<mock::output*>(data);
+
+    wl_resource* const r = create(client, wl_output_interface, version, id);
+
+    if(r == nullptr)
+    {
+        return;
+    }
+
+    wl_resource_set_implementation(r, std::addressof(implementation::output), o, callback::resource::output_unbound);
+    o->resources.push_back(r);
+
+    const auto& i = o->info;
+
+    wl_output_send_geometry(r,
+                            i.position.x,
+                            i.position.y,
+                            0,
+                            0,
+                            WL_OUTPUT_SUBPIXEL_UNKNOWN,
+                            i.make.c_str(),
+                            i.model.c_str(),
+                            WL_OUTPUT_TRANSFORM_NORMAL);
+
+    wl_output_send_mode(r,
+                        WL_OUTPUT_MODE_CURRENT | WL_OUTPUT_MODE_PREFERRED,
+                        i.resolution.width,
+                        i.resolution.height,
+                        static_cast<std::int32_t>(i.refresh_rate));
+
+    if(version >= WL_OUTPUT_SCALE_SINCE_VERSION)
+    {
+        wl_output_send_scale(r, i.scale);
+    }
+
+    if(version >= WL_OUTPUT_NAME_SINCE_VERSION)
+    {
+        wl_output_send_name(r, i.name.c_str());
+        wl_output_send_description(r, (i.make + " " + i.model).c_str());
+    }
+
+    if(version >= WL_OUTPUT_DONE_SINCE_VERSION)
+    {
+        wl_output_send_done(r);
+    }
+}
+
+void seat(wl_client* client, void* data, std::uint32_t version, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, wl_seat_interface, version, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::seat), data, nullptr);
+
+        // No input event is ever sent
+        wl_seat_send_capabilities(r, WL_SEAT_CAPABILITY_POINTER | WL_SEAT_CAPABILITY_KEYBOARD);
+
+        if(version >= WL_SEAT_NAME_SINCE_VERSION)
+        {
+            wl_seat_send_name(r, "seat0");
+        }
+    }
+}
+
+void wm_base(wl_client* client, void* data, std::uint32_t version, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, xdg_wm_base_interface, version, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::wm_base), data, nullptr);
+    }
+}
+
+void decoration_manager(wl_client* client, void* data, std::uint32_t version, std::uint32_t id) noexcept
+{
+    if(wl_resource* const r = create(client, zxdg_decoration_manager_v1_interface, version, id))
+    {
+        wl_resource_set_implementation(r, std::addressof(implementation::decoration_manager), data, nullptr);
+    }
+}
+
+} // namespace bind
+
+/// Creates a socket listening at an absolute path, for wl_display_add_socket_fd. @returns The socket, or -1 on error.
+[[nodiscard]] int listen_at(const std::string& path) noexcept
+{
+    // Same as wl_display_add_socket
+    constexpr int backlog = 128;
+
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+
+    if(path.size() >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+
+    std::ranges::copy(path, address.sun_path);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if(fd < 0)
+    {
+        return -1;
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if(::bind(fd, reinterpret_cast<const sockaddr*>(std::addressof(address)), sizeof(address)) != 0 or ::listen(fd, backlog) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/// Advertises a global at the version the compositor implements, or at the version of the protocol definition if it is older.
+[[nodiscard]] bool add_global(server& srv, const wl_interface& i, std::uint32_t ours, wl_global_bind_func_t bind) noexcept
+{
+    return wl_global_create(srv.display, &i, advertised(i, ours), &srv, bind) != nullptr;
+}
+
+void server::run() noexcept
+{
+    while(not stop.load(std::memory_order_acquire))
+    {
+        wl_display_flush_clients(display);
+
+        if(wl_event_loop_dispatch(loop, -1) < 0 and errno != EINTR)
+        {
+            std::cerr << "Mock compositor: wl_event_loop_dispatch failed\n" << std::flush;
+            return;
+        }
+
+        // What the requests caused is sent by the next flush
+        if(const auto latency = std::chrono::nanoseconds{latency_ns.load(std::memory_order_relaxed)}; latency.count() > 0)
+        {
+            std::this_thread::sleep_for(latency);
+        }
+    }
+}
+
+void server::post(std::function<void(server&)> command)
+{
+    {
+        const std::scoped_lock lock{mutex};
+        commands.push_back(std::move(command));
+    }
+
+    const std::uint64_t one = 1;
+    std::ignore             = write(wake.get().value, &one, sizeof(one));
+}
+
+void server::add_output(output_info info)
+{
+    auto o  = std::make_unique<output>();
+    o->info = std::move(info);
+
+    o->global = wl_global_create(display, &wl_output_interface, advertised(wl_output_interface, output_v), o.get(), bind::output);
+
+    if(o->global != nullptr)
+    {
+        outputs.push_back(std::move(o));
+    }
+}
+
+void server::remove_output(std::string_view name)
+{
+    std::erase_if(outputs,
+                  [name](const std::unique_ptr<output>& o)
+                  {
+                      if(o->info.name != name)
+                      {
+                          return false;
+                      }
+
+                      // Clients release their wl_output once they see the global go
+                      for(auto* const r : o->resources)
+                      {
+                          wl_resource_set_user_data(r, nullptr);
+                      }
+
+                      wl_global_destroy(o->global);
+                      return true;
+                  });
+}
+
+void server::send_frames() noexcept
+{
+    const auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<wl_resource*> ready;
+
+    for(const auto& f : frames)
+    {
+        if(f.committed)
+        {
+            ready.push_back(f.callback);
+        }
+    }
+
+    // Destroying a callback removes it from frames
+    for(auto* const callback : ready)
+    {
+        wl_callback_send_done(callback, static_cast<std::uint32_t>(time));
+        wl_resource_destroy(callback);
+    }
+
+    counters.frames += ready.size();
+}
+
+void server::commit(surface& s) noexcept
+{
+    ++counters.commits;
+
+    // Buffers are never read: they can be reused at once
+    if(s.attached.buffer != nullptr)
+    {
+        wl_buffer_send_release(s.attached.buffer);
+        detach(s.attached);
+    }
+
+    for(auto& f : frames)
+    {
+        if(f.target == std::addressof(s))
+        {
+            f.committed = true;
+        }
+    }
+
+    if(config.frame_interval.count() == 0)
+    {
+        send_frames();
+    }
+
+    if(s.toplevel == nullptr or s.role == nullptr)
+    {
+        return;
+    }
+
+    if(std::exchange(s.initial, false) or std::exchange(s.acked, false))
+    {
+        send_configure(s);
+    }
+}
+
+void server::send_configure(surface& s) noexcept
+{
+    // The initial commit is always answered
+    if(s.next_configure >= config.configures.size() and s.next_configure > 0)
+    {
+        return;
+    }
+
+    const auto size = (s.next_configure < config.configures.size()) ? config.configures[s.next_configure] : dimension2d{0, 0};
+    ++s.next_configure;
+
+    wl_array states = {};
+    wl_array_init(&states);
+
+    xdg_toplevel_send_configure(s.toplevel, size.width, size.height, &states);
+    xdg_surface_send_configure(s.role, wl_display_next_serial(display));
+
+    wl_array_release(&states);
+
+    ++counters.configures;
+}
+
+} // namespace
+
+struct compositor::state
+{
+    server impl;
+};
+
+void compositor::state_deleter::operator()(state* s) const noexcept
+{
+    auto& srv = s->impl;
+
+    if(srv.thread.joinable())
+    {
+        srv.stop.store(true, std::memory_order_release);
+
+        const std::uint64_t one = 1;
+        std::ignore             = write(srv.wake.get().value, &one, sizeof(one));
+
+        srv.thread.join();
+    }
+
+    if(srv.display != nullptr)
+    {
+        // Destroys every resource, then the globals and the socket
+        wl_display_destroy_clients(srv.display);
+        wl_display_destroy(srv.display);
+    }
+
+    // Sockets added by file descriptor are closed by wl_display_destroy, but not unlinked
+    if(not srv.socket.empty())
+    {
+        unlink(srv.socket.c_str());
+    }
+
+    if(not srv.directory.empty())
+    {
+        rmdir(srv.directory.c_str());
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete s;
+}
+
+compositor::~compositor() noexcept = default;
+
+[[nodiscard]] std::expected<compositor, compositor::any_call_info> compositor::make(script s) noexcept
+{
+    compositor result{token{}};
+
+    if(const auto error = result.create(std::move(s)))
+    {
+        return std::unexpected{*error};
+    }
+
+    return result;
+}
+
+[[nodiscard]] std::optional<compositor::any_call_info> compositor::create(script s) noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    m_state.reset(new state{});
+
+    auto& srv = m_state->impl;
+
+    srv.config = std::move(s);
+    srv.latency_ns.store(srv.config.latency.count(), std::memory_order_relaxed);
+
+    const int wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if(wake < 0)
+    {
+        return any_call_info{};
+    }
+
+    srv.wake = file_descriptor{file_descriptor::handle{wake}};
+
+    srv.display = wl_display_create();
+
+    if(srv.display == nullptr)
+    {
+        return any_call_info{};
+    }
+
+    srv.loop = wl_display_get_event_loop(srv.display);
+
+    // Not in XDG_RUNTIME_DIR, which headless boxes often lack: the socket is in a directory of its own, and clients connect with its
+    // absolute path. The environment is left alone, since other threads may read it
+    std::string dir = "/tmp/fubuki-mock-XXXXXX";
+
+    if(mkdtemp(dir.data()) == nullptr)
+    {
+        return any_call_info{};
+    }
+
+    srv.directory = std::move(dir);
+    srv.socket    = srv.directory + "/wayland-0";
+
+    const int listening = listen_at(srv.socket);
+
+    if(listening < 0)
+    {
+        return any_call_info{};
+    }
+
+    // Owned by the display on success only
+    if(wl_display_add_socket_fd(srv.display, listening) != 0)
+    {
+        close(listening);
+        return any_call_info{};
+    }
+
+    srv.clients = {.created = {.link = {}, .notify = callback::client_created}, .owner = std::addressof(srv)};
+    wl_display_add_client_created_listener(srv.display, &srv.clients.created);
+
+    const bool created = add_global(srv, wl_compositor_interface, compositor_v, bind::compositor)
+                     and add_global(srv, wl_shm_interface, shm_v, bind::shm)
+                     and add_global(srv, wl_seat_interface, seat_v, bind::seat)
+                     and add_global(srv, xdg_wm_base_interface, wm_base_v, bind::wm_base)
+                     and add_global(srv, zxdg_decoration_manager_v1_interface, decoration_v, bind::decoration_manager);
+
+    if(not created)
+    {
+        return any_call_info{};
+    }
+
+    for(auto& o : srv.config.outputs)
+    {
+        srv.add_output(std::move(o));
+    }
+
+    srv.config.outputs.clear();
+
+    srv.wake_source = wl_event_loop_add_fd(srv.loop, srv.wake.get().value, WL_EVENT_READABLE, callback::wake, &srv);
+
+    if(srv.wake_source == nullptr)
+    {
+        return any_call_info{};
+    }
+
+    if(srv.config.frame_interval.count() > 0)
+    {
+        srv.frame_timer = wl_event_loop_add_timer(srv.loop, callback::tick, &srv);
+
+        if(srv.frame_timer == nullptr)
+        {
+            return any_call_info{};
+        }
+
+        callback::tick(&srv);
+    }
+
+    try
+    {
+        srv.thread = std::thread{[&srv] { srv.run(); }};
+    }
+    catch(const std::system_error&)
+    {
+        return any_call_info{};
+    }
+
+    return {};
+}
+
+[[nodiscard]] const char* compositor::socket_name() const noexcept { return m_state->impl.socket.c_str(); }
+
+void compositor::add_output(output_info o)
+{
+    m_state->impl.post([o = std::move(o)](server& srv) { srv.add_output(o); });
+}
+
+void compositor::remove_output(std::string_view name)
+{
+    m_state->impl.post([n = std::string{name}](server& srv) { srv.remove_output(n); });
+}
+
+void compositor::set_latency(std::chrono::nanoseconds latency) noexcept
+{
+    m_state->impl.latency_ns.store(latency.count(), std::memory_order_relaxed);
+}
+
+[[nodiscard]] compositor::statistics compositor::stats() const noexcept
+{
+    const auto& c = m_state->impl.counters;
+
+    return {
+        .clients    = c.clients.load(std::memory_order_relaxed),
+        .surfaces   = c.surfaces.load(std::memory_order_relaxed),
+        .buffers    = c.buffers.load(std::memory_order_relaxed),
+        .commits    = c.commits.load(std::memory_order_relaxed),
+        .configures = c.configures.load(std::memory_order_relaxed),
+        .frames     = c.frames.load(std::memory_order_relaxed),
+    };
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland::mock
@@ -0,0 +1,183 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_MOCK_COMPOSITOR_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_MOCK_COMPOSITOR_HPP
+
+#include "../types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * Headless compositor, for benchmarks and tests that need a Wayland server but not a screen.
+ * It runs in the process, on a thread of its own, and listens on a socket of its own: clients connect with display::make(socket_name()).
+ * It implements wl_compositor, wl_shm, wl_output, wl_seat, xdg_wm_base and zxdg_decoration_manager_v1, enough for windows to be created,
+ * configured, drawn and resized. Buffers are released as soon as they are committed, and never read.
+ * Only built with the FUBUKI_MOCK_COMPOSITOR CMake option, which defines FUBUKI_HAS_MOCK_COMPOSITOR.
+ */
+namespace fubuki::io::platform::linux_bsd::wayland::mock
+{
+
+/// An output the compositor advertises.
+struct output_info
+{
+    static constexpr std::int32_t  default_width        = 1920;
+    static constexpr std::int32_t  default_height       = 1080;
+    static constexpr std::uint32_t default_refresh_rate = 60000;
+
+    std::string   name         = "MOCK-1";                        ///< Unique name, sent to clients binding version 4 or later.
+    std::string   make         = "fubuki";                        ///< Manufacturer.
+    std::string   model        = "mock";                          ///< Model.
+    position2d    position     = {0, 0};                          ///< Position in the global compositor space.
+    dimension2d   resolution   = {default_width, default_height}; ///< Current mode, the only one advertised.
+    std::uint32_t refresh_rate = default_refresh_rate;            ///< Refresh rate of the mode, in mHz.
+    std::int32_t  scale        = 1;                               ///< Scale factor.
+};
+
+/// What the compositor advertises, and how it answers.
+struct script
+{
+    static constexpr std::chrono::nanoseconds default_frame_interval = std::chrono::microseconds{16'667};
+
+    /// Outputs advertised from the start. Others can be plugged and unplugged later, see compositor::add_output.
+    std::vector<output_info> outputs = {output_info{}};
+
+    /**
+     * Sizes sent by the successive configure events of every toplevel. The first one is sent in response to the initial commit, each
+     * other one after the client acknowledged the previous one and committed. {0, 0} lets the client choose. No configure event follows
+     * the last one.
+     */
+    std::vector<dimension2d> configures = {dimension2d{0, 0}};
+
+    /// Period of frame events. Surfaces committed with a frame request are answered on the next tick. Zero answers at commit.
+    std::chrono::nanoseconds frame_interval = default_frame_interval;
+
+    /// Time the compositor waits after handling requests, before it sends what they caused. Delays every roundtrip and configure.
+    std::chrono::nanoseconds latency = {};
+
+    /// Mode sent to decoration objects: server side if true, client side otherwise.
+    bool server_side_decorations = true;
+};
+
+class compositor
+{
+    struct token
+    {
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    /// What the compositor received. Read from any thread.
+    struct statistics
+    {
+        std::size_t clients    = 0; ///< Clients that connected.
+        std::size_t surfaces   = 0; ///< Surfaces created.
+        std::size_t buffers    = 0; ///< Buffers created.
+        std::size_t commits    = 0; ///< Surface commits.
+        std::size_t configures = 0; ///< Configure events sent.
+        std::size_t frames     = 0; ///< Frame events sent.
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const statistics& s)
+        {
+            return out << "mock compositor:{clients: " << s.clients << ", surfaces: " << s.surfaces << ", buffers: " << s.buffers
+                       << ", commits: " << s.commits << ", configures: " << s.configures << ", frames: " << s.frames << "}";
+        }
+    };
+
+    compositor(const compositor&)            = delete;
+    compositor& operator=(const compositor&) = delete;
+
+    compositor(compositor&& other) noexcept : m_state{std::exchange(other.m_state, nullptr)} {}
+
+    compositor& operator=(compositor&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    /// Stops the thread of the compositor, which disconnects its clients.
+    ~compositor() noexcept;
+
+    /// Creates the socket of the compositor, then starts its thread.
+    [[nodiscard]] static std::expected<compositor, any_call_info> make(script s = {}) noexcept;
+
+    /// Returns the absolute path of the socket of the compositor, to connect to with display::make.
+    [[nodiscard]] const char* socket_name() const noexcept;
+
+    /// Plugs an output. Thread-safe: advertised once the compositor thread handles it, like a hotplug.
+    void add_output(output_info o);
+
+    /// Unplugs the outputs of a given name. Thread-safe.
+    void remove_output(std::string_view name);
+
+    /// Changes the latency of the compositor. Thread-safe. @see script::latency
+    void set_latency(std::chrono::nanoseconds latency) noexcept;
+
+    /// Returns a copy of the counters of the compositor. Thread-safe.
+    [[nodiscard]] statistics stats() const noexcept;
+
+    void swap(compositor& other) noexcept { std::swap(m_state, other.m_state); }
+
+    friend void swap(compositor& a, compositor& b) noexcept { a.swap(b); }
+
+private:
+
+    struct state;
+
+    // state is incomplete here
+    struct state_deleter
+    {
+        void operator()(state* s) const noexcept;
+    };
+
+    explicit compositor(token) noexcept {}
+
+    [[nodiscard]] std::optional<any_call_info> create(script s) noexcept;
+
+    /// Lives on the heap: the thread of the compositor refers to it.
+    std::unique_ptr<state, state_deleter> m_state = {};
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland::mock
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_MOCK_COMPOSITOR_HPP
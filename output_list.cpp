@@ -0,0 +1,253 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "output_list.hpp"
+#include "protocol_stats.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+/// Version 4 adds the name event.
+constexpr std::uint32_t output_interface_v = 4;
+
+/// Version 3 adds the release request.
+constexpr std::uint32_t release_v = 3;
+
+void release(wl_output* handle) noexcept
+{
+    if(wl_output_get_version(handle) >= release_v)
+    {
+        protocol_stats::send<WL_OUTPUT_RELEASE>(wl_output_release, handle);
+    }
+    else
+    {
+        wl_output_destroy(handle);
+    }
+}
+
+namespace callback::output
+{
+
+[[nodiscard]] screen_properties& pending(void* data, wl_output* handle) noexcept
+{
+    return static_cast<output_list*>(data)->find(handle).pending;
+}
+
+void geometry(void*        data,
+              wl_output*   handle,
+              std::int32_t x,
+              std::int32_t y,
+              std::int32_t /*physical_width*/,
+              std::int32_t /*physical_height*/,
+              std::int32_t /*subpixel*/,
+              const char*  make,
+              const char*  model,
+              std::int32_t /*transform*/) noexcept
+{
+    auto& next = pending(data, handle);
+
+    next.area.offset = {x, y};
+
+    // Newer outputs send their name separately. It is unique, unlike the make and the model
+    if(wl_output_get_version(handle) < output_interface_v)
+    {
+        next.name = std::string{make} + "-" + model;
+    }
+}
+
+void mode(void* data, wl_output* handle, std::uint32_t flags, std::int32_t width, std::int32_t height, std::int32_t refresh) noexcept
+{
+    constexpr std::uint32_t millihertz = 1000;
+
+    auto& next = pending(data, handle);
+
+    const screen_properties::config c = {.resolution = {width, height}, .refresh_rate = static_cast<std::uint32_t>(refresh) / millihertz};
+
+    if(std::ranges::find(next.configurations, c) == next.configurations.end())
+    {
+        next.configurations.push_back(c);
+    }
+
+    if((flags & WL_OUTPUT_MODE_CURRENT) != 0)
+    {
+        next.area.extent  = c.resolution;
+        next.refresh_rate = c.refresh_rate;
+    }
+}
+
+void done(void* data, wl_output* handle) noexcept
+{
+    static_cast<output_list*>(data)->apply(handle);
+}
+
+void scale(void* data, wl_output* handle, std::int32_t factor) noexcept
+{
+    pending(data, handle).scale = static_cast<std::uint32_t>(std::max(factor, 1));
+}
+
+void name(void* data, wl_output* handle, const char* n) noexcept
+{
+    pending(data, handle).name = n;
+}
+
+} // namespace callback::output
+
+namespace listener
+{
+
+using protocol_stats::counted;
+
+constexpr wl_output_listener output{
+    .geometry    = counted<&wl_output_listener::geometry, callback::output::geometry>,
+    .mode        = counted<&wl_output_listener::mode, callback::output::mode>,
+    .done        = counted<&wl_output_listener::done, callback::output::done>,
+    .scale       = counted<&wl_output_listener::scale, callback::output::scale>,
+    .name        = counted<&wl_output_listener::name, callback::output::name>,
+    .description = counted<&wl_output_listener::description>,
+};
+
+} // namespace listener
+
+} // namespace
+
+output_list::~output_list() noexcept
+{
+    for(const auto& o : m_outputs)
+    {
+        release(o.handle);
+    }
+}
+
+void output_list::bind(wl_registry* registry, std::uint32_t name, std::uint32_t version) noexcept
+{
+    auto* const handle = static_cast<wl_output*>(
+        protocol_stats::send<WL_REGISTRY_BIND>(wl_registry_bind, registry, name, &wl_output_interface, std::min(version, output_interface_v)));
+
+    if(handle == nullptr)
+    {
+        return;
+    }
+
+    screen_properties initial = {};
+    initial.device            = m_next_device++;
+
+    m_outputs.push_back({.handle = handle, .name = name, .current = initial, .pending = initial});
+    wl_output_add_listener(handle, std::addressof(listener::output), this);
+}
+
+bool output_list::remove(std::uint32_t name) noexcept
+{
+    const auto it = std::ranges::find(m_outputs, name, &output::name);
+
+    if(it == m_outputs.end())
+    {
+        return false;
+    }
+
+    const bool              described = it->ready;
+    const screen_properties last      = std::move(it->current);
+
+    release(it->handle);
+    m_outputs.erase(it);
+
+    if(described)
+    {
+        publish(change::removed, last);
+    }
+
+    return true;
+}
+
+void output_list::apply(wl_output* handle) noexcept
+{
+    auto& o = find(handle);
+
+    if(o.ready and o.current == o.pending)
+    {
+        return;
+    }
+
+    const auto c = o.ready ? change::changed : change::added;
+
+    o.current = o.pending;
+    o.ready   = true;
+
+    publish(c, o.current);
+}
+
+[[nodiscard]] auto output_list::find(wl_output* handle) noexcept -> output&
+{
+    return *std::ranges::find(m_outputs, handle, &output::handle);
+}
+
+void output_list::publish(change c, const screen_properties& properties) noexcept
+{
+    try
+    {
+        auto next = std::make_shared<std::vector<screen_properties>>();
+        next->reserve(m_outputs.size());
+
+        for(const auto& o : m_outputs)
+        {
+            if(o.ready)
+            {
+                next->push_back(o.current);
+            }
+        }
+
+        m_snapshot.store(std::move(next), std::memory_order_release);
+    }
+    catch(const std::bad_alloc&)
+    {
+        // The outputs themselves are up to date, only readers on other threads see an outdated copy
+        std::cerr << "Failed to publish the outputs\n" << std::flush;
+    }
+
+    if(m_on_change)
+    {
+        m_on_change(c, properties);
+    }
+}
+
+void output_list::repoint() noexcept
+{
+    for(const auto& o : m_outputs)
+    {
+        wl_output_set_user_data(o.handle, this);
+    }
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
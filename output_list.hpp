@@ -0,0 +1,161 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_OUTPUT_LIST_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_OUTPUT_LIST_HPP
+
+#include "screen_properties.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Outputs of a compositor, tracked as they are added, described and removed.
+ * Events are handled on the thread dispatching the default queue of the display. Every time the state of the outputs changes, an
+ * immutable copy of their properties is published, which any thread can read with screens() without waiting for events to be dispatched.
+ * Publishing and reading are not lock-free: std::atomic<std::shared_ptr> guards the pointer with a short internal lock in libstdc++, held
+ * while the reference count is updated.
+ */
+class output_list
+{
+public:
+
+    /// What happened to an output.
+    enum class change
+    {
+        added,   ///< The output was described for the first time.
+        changed, ///< The properties of the output changed.
+        removed, ///< The output was unplugged, or disabled.
+    };
+
+    /// Called on the dispatching thread after a change was published.
+    using change_callback = std::function<void(change c, const screen_properties& properties)>;
+
+    /// Properties of every described output, in the order they were added. Never modified once published.
+    using snapshot = std::shared_ptr<const std::vector<screen_properties>>;
+
+    struct output
+    {
+        wl_output*        handle  = nullptr;
+        std::uint32_t     name    = 0;     ///< Name of the global in the registry.
+        screen_properties current = {};    ///< State as of the last wl_output.done event.
+        screen_properties pending = {};    ///< State being received, applied by the next wl_output.done event.
+        bool              ready   = false; ///< True once current holds a complete state.
+    };
+
+    output_list() noexcept = default;
+
+    output_list(const output_list&)            = delete;
+    output_list& operator=(const output_list&) = delete;
+
+    output_list(output_list&& other) noexcept
+        : m_outputs{std::move(other.m_outputs)},
+          m_snapshot{other.m_snapshot.exchange(nullptr)},
+          m_on_change{std::move(other.m_on_change)},
+          m_next_device{std::exchange(other.m_next_device, 0)}
+    {
+        repoint();
+    }
+
+    output_list& operator=(output_list&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    /// Destructor. Releases the outputs.
+    ~output_list() noexcept;
+
+    /// Binds an output announced by the registry. Its properties are published once the compositor described it.
+    void bind(wl_registry* registry, std::uint32_t name, std::uint32_t version) noexcept;
+
+    /**
+     * Releases an output removed from the registry, and publishes the remaining ones.
+     * @returns False if the global was not an output of this list.
+     */
+    bool remove(std::uint32_t name) noexcept;
+
+    /// Applies the pending state of an output, on wl_output.done.
+    void apply(wl_output* handle) noexcept;
+
+    /// Returns an output of the list. The behaviour is undefined if the output is not in the list.
+    [[nodiscard]] output& find(wl_output* handle) noexcept;
+
+    /// Returns the last published properties of the outputs. Null until the first output was described. Thread-safe, see the class.
+    [[nodiscard]] snapshot screens() const noexcept { return m_snapshot.load(std::memory_order_acquire); }
+
+    /// Returns the outputs, including the ones that were not described yet. Only valid on the dispatching thread.
+    [[nodiscard]] const auto& entries() const noexcept { return m_outputs; }
+
+    [[nodiscard]] auto size() const noexcept { return m_outputs.size(); }
+
+    /// Sets the function called after each change. Replaces the previous one.
+    void on_change(change_callback c) noexcept { m_on_change = std::move(c); }
+
+    void swap(output_list& other) noexcept
+    {
+        m_outputs.swap(other.m_outputs);
+        m_snapshot.store(other.m_snapshot.exchange(m_snapshot.load()));
+        m_on_change.swap(other.m_on_change);
+        std::swap(m_next_device, other.m_next_device);
+
+        repoint();
+        other.repoint();
+    }
+
+    friend void swap(output_list& a, output_list& b) noexcept { a.swap(b); }
+
+private:
+
+    /**
+     * Publishes the properties of the described outputs, then calls the change callback.
+     * If the copy cannot be allocated, the previous one stays published until the next change.
+     */
+    void publish(change c, const screen_properties& properties) noexcept;
+
+    /// Points the user data of the outputs to this object.
+    void repoint() noexcept;
+
+    std::vector<output>   m_outputs     = {};
+    std::atomic<snapshot> m_snapshot    = {};
+    change_callback       m_on_change   = {};
+    std::uint32_t         m_next_device = 0; ///< Device index of the next output. Indices are never reused.
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_OUTPUT_LIST_HPP
@@ -0,0 +1,764 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "pixel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define FUBUKI_PIXEL_HAS_X86
+    #include <immintrin.h>
+#endif
+
+namespace fubuki::io::platform::linux_bsd::wayland::pixel
+{
+
+namespace
+{
+
+constexpr std::size_t pixel_size = 4; // 32-bit, 4 bytes
+constexpr std::size_t alpha_byte = 3; // Little-endian ARGB8888 is stored as B, G, R, A
+
+using kernel       = void (*)(std::byte*, std::size_t, std::uint8_t) noexcept;
+using fill_kernel  = void (*)(std::byte*, std::size_t, std::uint32_t) noexcept;
+using blend_kernel = void (*)(std::byte*, const std::byte*, std::size_t) noexcept;
+
+/// x * a / 255, rounded to the nearest, without a division.
+[[nodiscard]] constexpr std::uint8_t mul_div_255(std::uint8_t x, std::uint8_t a) noexcept
+{
+    const auto t = (static_cast<std::uint32_t>(x) * a) + 128U;
+    return static_cast<std::uint8_t>((t + (t >> 8U)) >> 8U);
+}
+
+namespace scalar
+{
+
+void set_alpha(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    for(std::size_t i = alpha_byte; i < size; i += pixel_size)
+    {
+        data[i] = std::byte{alpha};
+    }
+}
+
+void premultiply(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    for(std::size_t i = 0; i < size; ++i)
+    {
+        data[i] = std::byte{mul_div_255(std::to_integer<std::uint8_t>(data[i]), alpha)};
+    }
+}
+
+void fill(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    for(std::size_t i = 0; i + pixel_size <= size; i += pixel_size)
+    {
+        std::memcpy(data + i, &colour, pixel_size);
+    }
+}
+
+/// Source-over of one premultiplied pixel.
+void over(std::byte* dst, const std::byte* src) noexcept
+{
+    constexpr std::uint32_t max = 0xFF;
+
+    const auto inverse = static_cast<std::uint8_t>(max - std::to_integer<std::uint8_t>(src[alpha_byte]));
+
+    for(std::size_t c = 0; c < pixel_size; ++c)
+    {
+        const auto value = std::to_integer<std::uint32_t>(src[c]) + mul_div_255(std::to_integer<std::uint8_t>(dst[c]), inverse);
+        dst[c]           = static_cast<std::byte>(std::min(value, max));
+    }
+}
+
+void blend(std::byte* dst, const std::byte* src, std::size_t size) noexcept
+{
+    for(std::size_t i = 0; i + pixel_size <= size; i += pixel_size)
+    {
+        over(dst + i, src + i);
+    }
+}
+
+void blend_colour(std::byte* dst, std::size_t size, std::uint32_t colour) noexcept
+{
+    std::byte src[pixel_size] = {};
+    std::memcpy(src, &colour, pixel_size);
+
+    for(std::size_t i = 0; i + pixel_size <= size; i += pixel_size)
+    {
+        over(dst + i, src);
+    }
+}
+
+/// Number of bytes to fill before data is aligned on alignment bytes, at most size. data must be aligned on pixel_size.
+[[nodiscard]] std::size_t head(const std::byte* data, std::size_t size, std::size_t alignment) noexcept
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto misalignment = reinterpret_cast<std::uintptr_t>(data) % alignment;
+    return std::min(size, (alignment - misalignment) % alignment);
+}
+
+} // namespace scalar
+
+#if defined(FUBUKI_PIXEL_HAS_X86)
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, portability-simd-intrinsics)
+
+namespace sse2
+{
+
+[[gnu::target("sse2")]] void set_alpha(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    constexpr std::size_t step = sizeof(__m128i);
+
+    const __m128i colour = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i a      = _mm_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(alpha) << 24U));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(p), colour), a));
+    }
+
+    scalar::set_alpha(data + i, size - i, alpha);
+}
+
+[[gnu::target("sse2")]] inline __m128i mul_div_255(__m128i v, __m128i a, __m128i bias) noexcept
+{
+    v = _mm_add_epi16(_mm_mullo_epi16(v, a), bias);
+    return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+}
+
+[[gnu::target("sse2")]] void premultiply(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    constexpr std::size_t step = sizeof(__m128i);
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i a    = _mm_set1_epi16(static_cast<short>(alpha));
+    const __m128i bias = _mm_set1_epi16(128);
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const   p  = reinterpret_cast<__m128i*>(data + i);
+        const __m128i v  = _mm_loadu_si128(p);
+        const __m128i lo = mul_div_255(_mm_unpacklo_epi8(v, zero), a, bias);
+        const __m128i hi = mul_div_255(_mm_unpackhi_epi8(v, zero), a, bias);
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+
+    scalar::premultiply(data + i, size - i, alpha);
+}
+
+[[gnu::target("sse2")]] void fill(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m128i);
+
+    const __m128i v = _mm_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), v);
+    }
+
+    scalar::fill(data + i, size - i, colour);
+}
+
+[[gnu::target("sse2")]] void stream(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m128i);
+
+    const __m128i v = _mm_set1_epi32(static_cast<int>(colour));
+
+    // Streaming stores require aligned addresses
+    std::size_t i = scalar::head(data, size, step);
+    scalar::fill(data, i, colour);
+
+    for(; i + step <= size; i += step)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(data + i), v);
+    }
+
+    // Streaming stores are weakly ordered, make them visible before anything else the caller does, like a wl_surface.commit
+    _mm_sfence();
+
+    scalar::fill(data + i, size - i, colour);
+}
+
+/// Copies the alpha of each pixel, widened to 16 bits, to its four channels.
+[[gnu::target("sse2")]] inline __m128i broadcast_alpha(__m128i v) noexcept
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+[[gnu::target("sse2")]] inline __m128i over(__m128i src, __m128i dst) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max  = _mm_set1_epi16(0xFF);
+    const __m128i bias = _mm_set1_epi16(128);
+
+    const __m128i lo = mul_div_255(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(max, broadcast_alpha(_mm_unpacklo_epi8(src, zero))), bias);
+    const __m128i hi = mul_div_255(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(max, broadcast_alpha(_mm_unpackhi_epi8(src, zero))), bias);
+
+    return _mm_adds_epu8(src, _mm_packus_epi16(lo, hi));
+}
+
+[[gnu::target("sse2")]] void blend(std::byte* dst, const std::byte* src, std::size_t size) noexcept
+{
+    constexpr std::size_t step = sizeof(__m128i);
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const d = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(d, over(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), _mm_loadu_si128(d)));
+    }
+
+    scalar::blend(dst + i, src + i, size - i);
+}
+
+[[gnu::target("sse2")]] void blend_colour(std::byte* dst, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m128i);
+
+    const __m128i src = _mm_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const d = reinterpret_cast<__m128i*>(dst + i);
+        _mm_storeu_si128(d, over(src, _mm_loadu_si128(d)));
+    }
+
+    scalar::blend_colour(dst + i, size - i, colour);
+}
+
+} // namespace sse2
+
+namespace avx2
+{
+
+[[gnu::target("avx2")]] void set_alpha(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    constexpr std::size_t step = sizeof(__m256i);
+
+    const __m256i colour = _mm256_set1_epi32(0x00FFFFFF);
+    const __m256i a      = _mm256_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(alpha) << 24U));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256(p), colour), a));
+    }
+
+    sse2::set_alpha(data + i, size - i, alpha);
+}
+
+[[gnu::target("avx2")]] inline __m256i mul_div_255(__m256i v, __m256i a, __m256i bias) noexcept
+{
+    v = _mm256_add_epi16(_mm256_mullo_epi16(v, a), bias);
+    return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+}
+
+[[gnu::target("avx2")]] void premultiply(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    constexpr std::size_t step = sizeof(__m256i);
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i a    = _mm256_set1_epi16(static_cast<short>(alpha));
+    const __m256i bias = _mm256_set1_epi16(128);
+
+    std::size_t i = 0;
+
+    // Unpacking and packing both operate per 128-bit lane, so the pixel order is preserved
+    for(; i + step <= size; i += step)
+    {
+        auto* const   p  = reinterpret_cast<__m256i*>(data + i);
+        const __m256i v  = _mm256_loadu_si256(p);
+        const __m256i lo = mul_div_255(_mm256_unpacklo_epi8(v, zero), a, bias);
+        const __m256i hi = mul_div_255(_mm256_unpackhi_epi8(v, zero), a, bias);
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+
+    sse2::premultiply(data + i, size - i, alpha);
+}
+
+[[gnu::target("avx2")]] void fill(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m256i);
+
+    const __m256i v = _mm256_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), v);
+    }
+
+    sse2::fill(data + i, size - i, colour);
+}
+
+[[gnu::target("avx2")]] void stream(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m256i);
+
+    const __m256i v = _mm256_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = scalar::head(data, size, step);
+    sse2::fill(data, i, colour);
+
+    for(; i + step <= size; i += step)
+    {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(data + i), v);
+    }
+
+    _mm_sfence();
+
+    sse2::fill(data + i, size - i, colour);
+}
+
+[[gnu::target("avx2")]] inline __m256i broadcast_alpha(__m256i v) noexcept
+{
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+[[gnu::target("avx2")]] inline __m256i over(__m256i src, __m256i dst) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max  = _mm256_set1_epi16(0xFF);
+    const __m256i bias = _mm256_set1_epi16(128);
+
+    const __m256i lo
+        = mul_div_255(_mm256_unpacklo_epi8(dst, zero), _mm256_sub_epi16(max, broadcast_alpha(_mm256_unpacklo_epi8(src, zero))), bias);
+    const __m256i hi
+        = mul_div_255(_mm256_unpackhi_epi8(dst, zero), _mm256_sub_epi16(max, broadcast_alpha(_mm256_unpackhi_epi8(src, zero))), bias);
+
+    return _mm256_adds_epu8(src, _mm256_packus_epi16(lo, hi));
+}
+
+[[gnu::target("avx2")]] void blend(std::byte* dst, const std::byte* src, std::size_t size) noexcept
+{
+    constexpr std::size_t step = sizeof(__m256i);
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const d = reinterpret_cast<__m256i*>(dst + i);
+        _mm256_storeu_si256(d, over(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), _mm256_loadu_si256(d)));
+    }
+
+    sse2::blend(dst + i, src + i, size - i);
+}
+
+[[gnu::target("avx2")]] void blend_colour(std::byte* dst, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m256i);
+
+    const __m256i src = _mm256_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        auto* const d = reinterpret_cast<__m256i*>(dst + i);
+        _mm256_storeu_si256(d, over(src, _mm256_loadu_si256(d)));
+    }
+
+    sse2::blend_colour(dst + i, size - i, colour);
+}
+
+} // namespace avx2
+
+namespace avx512
+{
+
+/// Selects the alpha byte of each of the 16 pixels of a 512-bit register.
+constexpr __mmask64 alpha_lanes = 0x8888'8888'8888'8888ULL;
+
+/// Selects the first count bytes of a 512-bit register, count < 64.
+[[nodiscard]] constexpr __mmask64 first_bytes(std::size_t count) noexcept { return (__mmask64{1} << count) - 1U; }
+
+[[gnu::target("avx512f,avx512bw")]] void set_alpha(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    constexpr std::size_t step = sizeof(__m512i);
+
+    const __m512i a = _mm512_set1_epi8(static_cast<char>(alpha));
+
+    std::size_t i = 0;
+
+    // Masked stores only write the alpha bytes, there is no need to load the colour channels
+    for(; i + step <= size; i += step)
+    {
+        _mm512_mask_storeu_epi8(data + i, alpha_lanes, a);
+    }
+
+    if(i < size)
+    {
+        _mm512_mask_storeu_epi8(data + i, alpha_lanes & first_bytes(size - i), a);
+    }
+}
+
+[[gnu::target("avx512f,avx512bw")]] inline __m512i mul_div_255(__m512i v, __m512i a, __m512i bias) noexcept
+{
+    v = _mm512_add_epi16(_mm512_mullo_epi16(v, a), bias);
+    return _mm512_srli_epi16(_mm512_add_epi16(v, _mm512_srli_epi16(v, 8)), 8);
+}
+
+[[gnu::target("avx512f,avx512bw")]] inline __m512i premultiply(__m512i v, __m512i a, __m512i bias) noexcept
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i lo   = mul_div_255(_mm512_unpacklo_epi8(v, zero), a, bias);
+    const __m512i hi   = mul_div_255(_mm512_unpackhi_epi8(v, zero), a, bias);
+    return _mm512_packus_epi16(lo, hi);
+}
+
+[[gnu::target("avx512f,avx512bw")]] void premultiply(std::byte* data, std::size_t size, std::uint8_t alpha) noexcept
+{
+    constexpr std::size_t step = sizeof(__m512i);
+
+    const __m512i a    = _mm512_set1_epi16(static_cast<short>(alpha));
+    const __m512i bias = _mm512_set1_epi16(128);
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        _mm512_storeu_si512(data + i, premultiply(_mm512_loadu_si512(data + i), a, bias));
+    }
+
+    if(i < size)
+    {
+        const auto tail = first_bytes(size - i);
+        _mm512_mask_storeu_epi8(data + i, tail, premultiply(_mm512_maskz_loadu_epi8(tail, data + i), a, bias));
+    }
+}
+
+[[gnu::target("avx512f,avx512bw")]] void fill(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m512i);
+
+    const __m512i v = _mm512_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        _mm512_storeu_si512(data + i, v);
+    }
+
+    if(i < size)
+    {
+        _mm512_mask_storeu_epi8(data + i, first_bytes(size - i), v);
+    }
+}
+
+[[gnu::target("avx512f,avx512bw")]] void stream(std::byte* data, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m512i);
+
+    const __m512i v = _mm512_set1_epi32(static_cast<int>(colour));
+
+    // The head is shorter than a register: a masked store fills it, the colour pattern stays in phase since data is pixel-aligned
+    std::size_t i = scalar::head(data, size, step);
+
+    if(i > 0)
+    {
+        _mm512_mask_storeu_epi8(data, first_bytes(i), v);
+    }
+
+    for(; i + step <= size; i += step)
+    {
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(data + i), v);
+    }
+
+    _mm_sfence();
+
+    if(i < size)
+    {
+        _mm512_mask_storeu_epi8(data + i, first_bytes(size - i), v);
+    }
+}
+
+[[gnu::target("avx512f,avx512bw")]] inline __m512i broadcast_alpha(__m512i v) noexcept
+{
+    return _mm512_shufflehi_epi16(_mm512_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+[[gnu::target("avx512f,avx512bw")]] inline __m512i over(__m512i src, __m512i dst) noexcept
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i max  = _mm512_set1_epi16(0xFF);
+    const __m512i bias = _mm512_set1_epi16(128);
+
+    const __m512i lo
+        = mul_div_255(_mm512_unpacklo_epi8(dst, zero), _mm512_sub_epi16(max, broadcast_alpha(_mm512_unpacklo_epi8(src, zero))), bias);
+    const __m512i hi
+        = mul_div_255(_mm512_unpackhi_epi8(dst, zero), _mm512_sub_epi16(max, broadcast_alpha(_mm512_unpackhi_epi8(src, zero))), bias);
+
+    return _mm512_adds_epu8(src, _mm512_packus_epi16(lo, hi));
+}
+
+[[gnu::target("avx512f,avx512bw")]] void blend(std::byte* dst, const std::byte* src, std::size_t size) noexcept
+{
+    constexpr std::size_t step = sizeof(__m512i);
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        _mm512_storeu_si512(dst + i, over(_mm512_loadu_si512(src + i), _mm512_loadu_si512(dst + i)));
+    }
+
+    if(i < size)
+    {
+        const auto tail = first_bytes(size - i);
+        _mm512_mask_storeu_epi8(dst + i, tail, over(_mm512_maskz_loadu_epi8(tail, src + i), _mm512_maskz_loadu_epi8(tail, dst + i)));
+    }
+}
+
+[[gnu::target("avx512f,avx512bw")]] void blend_colour(std::byte* dst, std::size_t size, std::uint32_t colour) noexcept
+{
+    constexpr std::size_t step = sizeof(__m512i);
+
+    const __m512i src = _mm512_set1_epi32(static_cast<int>(colour));
+
+    std::size_t i = 0;
+
+    for(; i + step <= size; i += step)
+    {
+        _mm512_storeu_si512(dst + i, over(src, _mm512_loadu_si512(dst + i)));
+    }
+
+    if(i < size)
+    {
+        const auto tail = first_bytes(size - i);
+        _mm512_mask_storeu_epi8(dst + i, tail, over(src, _mm512_maskz_loadu_epi8(tail, dst + i)));
+    }
+}
+
+} // namespace avx512
+
+// NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, portability-simd-intrinsics)
+
+#endif // defined(FUBUKI_PIXEL_HAS_X86)
+
+[[nodiscard]] isa detect() noexcept
+{
+#if defined(FUBUKI_PIXEL_HAS_X86)
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512bw"))
+    {
+        return isa::avx512;
+    }
+
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return isa::avx2;
+    }
+
+    if(__builtin_cpu_supports("sse2"))
+    {
+        return isa::sse2;
+    }
+#endif // defined(FUBUKI_PIXEL_HAS_X86)
+
+    return isa::scalar;
+}
+
+struct kernels
+{
+    kernel       set_alpha    = scalar::set_alpha;
+    kernel       premultiply  = scalar::premultiply;
+    fill_kernel  fill         = scalar::fill;
+    fill_kernel  stream       = scalar::fill; ///< Same as fill, with non-temporal stores.
+    blend_kernel blend        = scalar::blend;
+    fill_kernel  blend_colour = scalar::blend_colour;
+};
+
+[[nodiscard]] kernels select(isa target) noexcept
+{
+    switch(std::min(target, detected_isa()))
+    {
+#if defined(FUBUKI_PIXEL_HAS_X86)
+        case isa::sse2  : return {sse2::set_alpha, sse2::premultiply, sse2::fill, sse2::stream, sse2::blend, sse2::blend_colour};
+        case isa::avx2  : return {avx2::set_alpha, avx2::premultiply, avx2::fill, avx2::stream, avx2::blend, avx2::blend_colour};
+        case isa::avx512: return {avx512::set_alpha, avx512::premultiply, avx512::fill, avx512::stream, avx512::blend, avx512::blend_colour};
+#endif // defined(FUBUKI_PIXEL_HAS_X86)
+        case isa::scalar:
+        default         : return {};
+    }
+}
+
+[[nodiscard]] const kernels& best() noexcept
+{
+    static const kernels k = select(detected_isa());
+    return k;
+}
+
+/// Size of the whole pixels contained in a range, in bytes.
+[[nodiscard]] constexpr std::size_t whole_pixels(std::span<std::byte> pixels) noexcept { return pixels.size() / pixel_size * pixel_size; }
+
+[[nodiscard]] std::size_t detect_last_level_cache() noexcept
+{
+    // Not every libc or CPU reports the L3 cache
+    for(const int name : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE})
+    {
+        if(const auto size = sysconf(name); size > 0)
+        {
+            return static_cast<std::size_t>(size);
+        }
+    }
+
+    constexpr std::size_t fallback = std::size_t{8} << 20U;
+
+    return fallback;
+}
+
+[[nodiscard]] fill_kernel fill_for(const kernels& k, std::size_t size, store s) noexcept
+{
+    const bool non_temporal = (s == store::non_temporal) or (s == store::automatic and size > streaming_threshold());
+    return non_temporal ? k.stream : k.fill;
+}
+
+} // namespace
+
+[[nodiscard]] isa detected_isa() noexcept
+{
+    static const isa i = detect();
+    return i;
+}
+
+void set_alpha(std::span<std::byte> pixels, std::uint8_t alpha, isa target) noexcept
+{
+    select(target).set_alpha(pixels.data(), whole_pixels(pixels), alpha);
+}
+
+void set_alpha(std::span<std::byte> pixels, std::uint8_t alpha) noexcept { best().set_alpha(pixels.data(), whole_pixels(pixels), alpha); }
+
+void premultiply(std::span<std::byte> pixels, std::uint8_t alpha, isa target) noexcept
+{
+    select(target).premultiply(pixels.data(), whole_pixels(pixels), alpha);
+}
+
+void premultiply(std::span<std::byte> pixels, std::uint8_t alpha) noexcept { best().premultiply(pixels.data(), whole_pixels(pixels), alpha); }
+
+[[nodiscard]] std::size_t streaming_threshold() noexcept
+{
+    static const std::size_t size = detect_last_level_cache();
+    return size;
+}
+
+void fill(std::span<std::byte> pixels, std::uint32_t colour, isa target, store s) noexcept
+{
+    const auto size = whole_pixels(pixels);
+    fill_for(select(target), size, s)(pixels.data(), size, colour);
+}
+
+void fill(std::span<std::byte> pixels, std::uint32_t colour) noexcept
+{
+    const auto size = whole_pixels(pixels);
+    fill_for(best(), size, store::automatic)(pixels.data(), size, colour);
+}
+
+void blend(std::span<std::byte> dst, std::span<const std::byte> src, isa target) noexcept
+{
+    select(target).blend(dst.data(), src.data(), std::min(whole_pixels(dst), src.size() / pixel_size * pixel_size));
+}
+
+void blend(std::span<std::byte> dst, std::span<const std::byte> src) noexcept
+{
+    best().blend(dst.data(), src.data(), std::min(whole_pixels(dst), src.size() / pixel_size * pixel_size));
+}
+
+void blend(std::span<std::byte> dst, std::uint32_t colour, isa target) noexcept
+{
+    select(target).blend_colour(dst.data(), whole_pixels(dst), colour);
+}
+
+void blend(std::span<std::byte> dst, std::uint32_t colour) noexcept { best().blend_colour(dst.data(), whole_pixels(dst), colour); }
+
+void fill_striped(std::span<std::byte> pixels, std::uint32_t colour, std::size_t max_threads) noexcept
+{
+    // Below this, starting a thread costs about as much as the stripe it would fill
+    constexpr std::size_t min_stripe = std::size_t{4} << 20U;
+
+    // Stripes start on a cache line, so that no line is written by two threads
+    constexpr std::size_t cache_line = 64;
+
+    const auto size = whole_pixels(pixels);
+
+    if(max_threads == 0)
+    {
+        max_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    const auto count  = std::clamp(size / min_stripe, std::size_t{1}, max_threads);
+    const auto stripe = (size / count + cache_line - 1) / cache_line * cache_line;
+
+    // The stripes are written concurrently: together they decide whether the cache is worth keeping
+    const auto f = fill_for(best(), size, store::automatic);
+
+    std::vector<std::jthread> workers = {};
+    workers.reserve(count - 1);
+
+    std::size_t offset = 0;
+
+    for(; offset + stripe < size and workers.size() + 1 < count; offset += stripe)
+    {
+        try
+        {
+            workers.emplace_back(f, pixels.data() + offset, stripe, colour);
+        }
+        catch(const std::system_error&)
+        {
+            break; // The calling thread fills what is left
+        }
+    }
+
+    f(pixels.data() + offset, size - offset, colour);
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland::pixel
@@ -0,0 +1,160 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PIXEL_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PIXEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+
+/**
+ * Kernels operating on ARGB8888 pixels, as stored in a shm_buffer (little-endian, premultiplied alpha).
+ * Each kernel is implemented for several instruction sets. The best one supported by the CPU is selected at runtime.
+ */
+namespace fubuki::io::platform::linux_bsd::wayland::pixel
+{
+
+/// Instruction sets the kernels are specialised for, from the least to the most capable.
+enum class isa
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512,
+};
+
+template<typename char_type, typename traits = std::char_traits<char_type>>
+inline std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, isa i)
+{
+    switch(i)
+    {
+        case isa::scalar: out << "scalar"; break;
+        case isa::sse2  : out << "sse2"; break;
+        case isa::avx2  : out << "avx2"; break;
+        case isa::avx512: out << "avx512"; break;
+        default         : out << "<Invalid isa. Perhaps static_cast?>"; break;
+    }
+
+    return out;
+}
+
+/// How fill writes memory.
+enum class store
+{
+    automatic,    ///< Non-temporal stores for ranges larger than streaming_threshold(), regular stores otherwise.
+    temporal,     ///< Regular stores. The pixels stay in the cache, which pays off if they are read soon after.
+    non_temporal, ///< Streaming stores, which bypass the cache instead of evicting everything else from it.
+};
+
+template<typename char_type, typename traits = std::char_traits<char_type>>
+inline std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, store s)
+{
+    switch(s)
+    {
+        case store::automatic   : out << "automatic"; break;
+        case store::temporal    : out << "temporal"; break;
+        case store::non_temporal: out << "non-temporal"; break;
+        default                 : out << "<Invalid store. Perhaps static_cast?>"; break;
+    }
+
+    return out;
+}
+
+/// Returns the most capable instruction set supported by the CPU. Detection happens once.
+[[nodiscard]] isa detected_isa() noexcept;
+
+/// Returns the size above which store::automatic uses non-temporal stores: the size of the last-level cache, queried once.
+[[nodiscard]] std::size_t streaming_threshold() noexcept;
+
+/**
+ * Sets the alpha channel of each pixel, leaving the colour channels untouched.
+ * @param pixels ARGB8888 pixels. Trailing bytes that do not form a whole pixel are ignored.
+ * @param alpha The new alpha value.
+ * @param target Instruction set to use. Clamped to detected_isa().
+ */
+void set_alpha(std::span<std::byte> pixels, std::uint8_t alpha, isa target) noexcept;
+
+/// Same as set_alpha(std::span<std::byte>, std::uint8_t, isa), using detected_isa().
+void set_alpha(std::span<std::byte> pixels, std::uint8_t alpha) noexcept;
+
+/**
+ * Multiplies every channel of each pixel, alpha included, by alpha / 255, rounded to the nearest.
+ * This applies an opacity to premultiplied contents.
+ * @param pixels ARGB8888 pixels. Trailing bytes that do not form a whole pixel are ignored.
+ * @param alpha The opacity to apply.
+ * @param target Instruction set to use. Clamped to detected_isa().
+ */
+void premultiply(std::span<std::byte> pixels, std::uint8_t alpha, isa target) noexcept;
+
+/// Same as premultiply(std::span<std::byte>, std::uint8_t, isa), using detected_isa().
+void premultiply(std::span<std::byte> pixels, std::uint8_t alpha) noexcept;
+
+/**
+ * Sets every pixel to a colour, in a single pass. Clearing to a translucent colour this way replaces a clear followed by set_alpha.
+ * @param pixels ARGB8888 pixels. Trailing bytes that do not form a whole pixel are ignored.
+ * @param colour Premultiplied colour, as 0xAARRGGBB.
+ * @param target Instruction set to use. Clamped to detected_isa().
+ * @param s How memory is written.
+ */
+void fill(std::span<std::byte> pixels, std::uint32_t colour, isa target, store s = store::automatic) noexcept;
+
+/// Same as fill(std::span<std::byte>, std::uint32_t, isa, store), using detected_isa() and store::automatic.
+void fill(std::span<std::byte> pixels, std::uint32_t colour) noexcept;
+
+/**
+ * Composites pixels over others (Porter-Duff source-over): dst = src + dst * (255 - src alpha) / 255, for each channel.
+ * @param dst ARGB8888 pixels, premultiplied. Only the pixels that src covers are modified.
+ * @param src ARGB8888 pixels, premultiplied. Trailing bytes that do not form a whole pixel are ignored.
+ * @param target Instruction set to use. Clamped to detected_isa().
+ */
+void blend(std::span<std::byte> dst, std::span<const std::byte> src, isa target) noexcept;
+
+/// Same as blend(std::span<std::byte>, std::span<const std::byte>, isa), using detected_isa().
+void blend(std::span<std::byte> dst, std::span<const std::byte> src) noexcept;
+
+/// Same as blend(std::span<std::byte>, std::span<const std::byte>, isa), compositing a single premultiplied colour, as 0xAARRGGBB, over
+/// every pixel of dst.
+void blend(std::span<std::byte> dst, std::uint32_t colour, isa target) noexcept;
+
+/// Same as blend(std::span<std::byte>, std::uint32_t, isa), using detected_isa().
+void blend(std::span<std::byte> dst, std::uint32_t colour) noexcept;
+
+/**
+ * Same as fill(std::span<std::byte>, std::uint32_t), splitting the pixels in stripes filled concurrently. The calling thread fills a stripe
+ * as well. Stripes are at least a few megabytes: smaller ranges are filled by fewer threads, small ones by the calling thread only.
+ * The threads are started and joined by each call, which is only worth it for one-off fills of large buffers: work repeated every frame
+ * belongs to a persistent pool, such as tile_renderer.
+ * @param max_threads Maximum number of threads, the calling one included. Zero uses std::thread::hardware_concurrency().
+ */
+void fill_striped(std::span<std::byte> pixels, std::uint32_t colour, std::size_t max_threads = 0) noexcept;
+
+} // namespace fubuki::io::platform::linux_bsd::wayland::pixel
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PIXEL_HPP
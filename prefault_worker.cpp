@@ -0,0 +1,81 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "prefault_worker.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace fubuki::io::platform::linux_bsd
+{
+
+[[nodiscard]] auto prefault_worker::make(std::span<std::byte> memory) noexcept -> std::expected<prefault_worker, any_call_info>
+{
+    try
+    {
+        return prefault_worker{token{}, std::jthread{run, memory}};
+    }
+    catch(const std::system_error&)
+    {
+        return std::unexpected{any_call_info{}};
+    }
+}
+
+void prefault_worker::run(std::stop_token stop, std::span<std::byte> memory) noexcept
+{
+    // Small enough steps to stop quickly, large enough to keep the number of syscalls low
+    constexpr std::size_t step = std::size_t{2} << 20U;
+
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+    for(std::size_t offset = 0; offset < memory.size() and not stop.stop_requested(); offset += step)
+    {
+        const auto part = memory.subspan(offset, std::min(step, memory.size() - offset));
+
+#if defined(MADV_POPULATE_WRITE)
+        // Requires Linux 5.14
+        if(madvise(part.data(), part.size(), MADV_POPULATE_WRITE) == 0)
+        {
+            continue;
+        }
+#endif
+
+        // Reading is enough for shared memory: the page is allocated (or found, if it was reserved) and mapped writable
+        for(std::size_t page = 0; page < part.size(); page += page_size)
+        {
+            // The read must happen, hence volatile
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            [[maybe_unused]] const unsigned char value = *reinterpret_cast<const volatile unsigned char*>(part.data() + page);
+        }
+    }
+}
+
+} // namespace fubuki::io::platform::linux_bsd
@@ -0,0 +1,112 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_PREFAULT_WORKER_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_PREFAULT_WORKER_HPP
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <thread>
+#include <utility>
+
+namespace fubuki::io::platform::linux_bsd
+{
+
+/**
+ * Faults the pages of a memory region in on a worker thread, so that the thread drawing into the region does not stall on page faults.
+ * Pages are populated with MADV_POPULATE_WRITE when the kernel supports it, and read one by one otherwise. The contents of the region are
+ * never modified: it can be written to while the worker runs.
+ * The worker is stopped and joined upon destruction. The region must stay mapped until then.
+ */
+class prefault_worker
+{
+    struct token
+    {
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    /// Default constructor. Does not start a worker.
+    prefault_worker() noexcept = default;
+
+    /**
+     * Constructor. Starts faulting the pages of a region in.
+     * @pre The region must be page-aligned.
+     * @throws std::system_error If the worker thread could not be started.
+     */
+    explicit prefault_worker(std::span<std::byte> memory) : m_worker{run, memory} {}
+
+    prefault_worker(const prefault_worker&)            = delete;
+    prefault_worker& operator=(const prefault_worker&) = delete;
+
+    prefault_worker(prefault_worker&& other) noexcept : m_worker{std::move(other.m_worker)} {}
+
+    prefault_worker& operator=(prefault_worker&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~prefault_worker() noexcept = default;
+
+    [[nodiscard]] static std::expected<prefault_worker, any_call_info> make(std::span<std::byte> memory) noexcept;
+
+    /// Returns true if a worker was started and was not stopped yet. The worker may have finished already.
+    [[nodiscard]] bool active() const noexcept { return m_worker.joinable(); }
+
+    /// Stops the worker and waits for it. Must be called before the region is unmapped or moved.
+    void stop() noexcept
+    {
+        if(m_worker.joinable())
+        {
+            m_worker.request_stop();
+            m_worker.join();
+        }
+    }
+
+    void swap(prefault_worker& other) noexcept { m_worker.swap(other.m_worker); }
+
+    friend void swap(prefault_worker& a, prefault_worker& b) noexcept { a.swap(b); }
+
+private:
+
+    prefault_worker(token, std::jthread worker) noexcept : m_worker{std::move(worker)} {}
+
+    static void run(std::stop_token stop, std::span<std::byte> memory) noexcept;
+
+    std::jthread m_worker = {};
+};
+
+} // namespace fubuki::io::platform::linux_bsd
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_PREFAULT_WORKER_HPP
@@ -0,0 +1,205 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "presentation_log.hpp"
+#include "protocol_stats.hpp"
+#include "wp/generated/presentation-time-client-protocol.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+[[nodiscard]] std::chrono::nanoseconds now(int clock) noexcept
+{
+    ::timespec t = {};
+    clock_gettime(clock, &t);
+
+    return std::chrono::seconds{t.tv_sec} + std::chrono::nanoseconds{t.tv_nsec};
+}
+
+[[nodiscard]] constexpr std::uint64_t join(std::uint32_t hi, std::uint32_t lo) noexcept
+{
+    return (std::uint64_t{hi} << 32U) | lo;
+}
+
+namespace callback::feedback
+{
+
+void presented(void*                            data,
+               struct wp_presentation_feedback* feedback,
+               std::uint32_t                    tv_sec_hi,
+               std::uint32_t                    tv_sec_lo,
+               std::uint32_t                    tv_nsec,
+               std::uint32_t                    refresh,
+               std::uint32_t                    seq_hi,
+               std::uint32_t                    seq_lo,
+               std::uint32_t                    flags) noexcept
+{
+    auto* const log = static_cast<presentation_log*>(data);
+
+    const auto seconds = std::chrono::seconds{static_cast<std::int64_t>(join(tv_sec_hi, tv_sec_lo))};
+
+    log->complete(feedback,
+                  {.present   = seconds + std::chrono::nanoseconds{tv_nsec},
+                   .refresh   = std::chrono::nanoseconds{refresh},
+                   .sequence  = join(seq_hi, seq_lo),
+                   .flags     = flags,
+                   .presented = true});
+}
+
+void discarded(void* data, struct wp_presentation_feedback* feedback) noexcept
+{
+    static_cast<presentation_log*>(data)->complete(feedback, {});
+}
+
+} // namespace callback::feedback
+
+namespace listener
+{
+
+using protocol_stats::counted;
+
+constexpr wp_presentation_feedback_listener feedback{
+    .sync_output = counted<&wp_presentation_feedback_listener::sync_output>,
+    .presented   = counted<&wp_presentation_feedback_listener::presented, callback::feedback::presented>,
+    .discarded   = counted<&wp_presentation_feedback_listener::discarded, callback::feedback::discarded>,
+};
+
+} // namespace listener
+
+} // namespace
+
+presentation_log::~presentation_log() noexcept
+{
+    for(const auto& p : std::span{m_pending}.first(m_pending_count))
+    {
+        wp_presentation_feedback_destroy(p.feedback);
+    }
+}
+
+void presentation_log::track(struct wp_presentation_feedback* feedback) noexcept
+{
+    if(feedback == nullptr)
+    {
+        return;
+    }
+
+    // The compositor stopped answering, for example because the surface is hidden: keep the oldest requests, which it answers first
+    if(m_pending_count == max_pending)
+    {
+        wp_presentation_feedback_destroy(feedback);
+        return;
+    }
+
+    m_pending[m_pending_count++] = {.feedback = feedback, .commit = now(m_clock)};
+
+    wp_presentation_feedback_add_listener(feedback, std::addressof(listener::feedback), this);
+}
+
+void presentation_log::complete(struct wp_presentation_feedback* feedback, record r) noexcept
+{
+    const auto pending = std::span{m_pending}.first(m_pending_count);
+    const auto it      = std::ranges::find(pending, feedback, &pending_commit::feedback);
+
+    wp_presentation_feedback_destroy(feedback);
+
+    if(it == pending.end())
+    {
+        return;
+    }
+
+    r.commit = it->commit;
+
+    // Keeps the pending requests in commit order
+    std::ranges::move(std::next(it), pending.end(), it);
+    --m_pending_count;
+
+    m_records[m_next] = r;
+    m_next            = (m_next + 1) % max_records;
+    m_count           = std::min(m_count + 1, max_records);
+}
+
+auto presentation_log::stats() const noexcept -> statistics
+{
+    constexpr auto vsync = std::uint32_t{WP_PRESENTATION_FEEDBACK_KIND_VSYNC};
+
+    statistics result = {};
+
+    const record* previous = nullptr;
+
+    for(std::size_t i = 0; i < m_count; ++i)
+    {
+        const auto& r = (*this)[i];
+
+        if(not r.presented)
+        {
+            ++result.discarded;
+            continue;
+        }
+
+        const auto latency = r.latency();
+
+        result.min_latency = (result.presented == 0) ? latency : std::min(result.min_latency, latency);
+        result.max_latency = std::max(result.max_latency, latency);
+        result.total_latency += latency;
+        ++result.presented;
+
+        const auto bucket = static_cast<std::size_t>(std::max(latency / bucket_width, std::int64_t{0}));
+        ++result.histogram[std::min(bucket, bucket_count - 1)];
+
+        const bool synchronised = previous != nullptr and ((previous->flags & r.flags & vsync) != 0) and previous->refresh.count() > 0;
+
+        // Ready before the refresh following the previous frame, so every retrace skipped since is a miss
+        if(synchronised and r.commit < previous->present + previous->refresh and r.sequence > previous->sequence + 1)
+        {
+            result.missed += r.sequence - previous->sequence - 1;
+        }
+
+        previous = std::addressof(r);
+    }
+
+    return result;
+}
+
+void presentation_log::repoint() noexcept
+{
+    for(const auto& p : std::span{m_pending}.first(m_pending_count))
+    {
+        wp_presentation_feedback_set_user_data(p.feedback, this);
+    }
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
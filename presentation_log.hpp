@@ -0,0 +1,207 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PRESENTATION_LOG_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PRESENTATION_LOG_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+#include <utility>
+
+struct wp_presentation_feedback;
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Records what became of the last commits of a surface, from wp_presentation_feedback events: when each one was presented, or whether
+ * it was discarded. Commit and presentation times are read from the same clock, the presentation clock of the display, so that their
+ * difference is the latency of the frame as seen by the user.
+ * Records are kept in a ring of max_records entries, the oldest being overwritten first. This class never allocates.
+ */
+class presentation_log
+{
+public:
+
+    static constexpr std::size_t max_records = 128;
+
+    /// Feedback requests awaiting an event. Past this, commits are not tracked until the compositor catches up.
+    static constexpr std::size_t max_pending = 8;
+
+    /// Width of the buckets of the latency histogram.
+    static constexpr std::chrono::milliseconds bucket_width{1};
+
+    /// Number of buckets of the latency histogram. The last bucket also counts every longer latency.
+    static constexpr std::size_t bucket_count = 64;
+
+    struct record
+    {
+        std::chrono::nanoseconds commit    = {}; ///< When the surface was committed, on the presentation clock.
+        std::chrono::nanoseconds present   = {}; ///< When the frame was presented, on the presentation clock. Zero if discarded.
+        std::chrono::nanoseconds refresh   = {}; ///< Predicted time until the next refresh of the output. Zero if unknown.
+        std::uint64_t            sequence  = 0;  ///< Vertical retrace counter of the output when the frame was presented.
+        std::uint32_t            flags     = 0;  ///< Combination of wp_presentation_feedback_kind.
+        bool                     presented = false;
+
+        [[nodiscard]] auto latency() const noexcept { return present - commit; }
+    };
+
+    struct statistics
+    {
+        std::size_t presented = 0;
+        std::size_t discarded = 0;
+
+        /**
+         * Number of refreshes a frame was ready for but missed: frames committed before the refresh following the previous presentation,
+         * yet presented after it. Only counted between frames synchronised with the vertical retrace of the same output.
+         */
+        std::uint64_t missed = 0;
+
+        std::chrono::nanoseconds min_latency   = {};
+        std::chrono::nanoseconds max_latency   = {};
+        std::chrono::nanoseconds total_latency = {};
+
+        std::array<std::uint32_t, bucket_count> histogram = {}; ///< Presented frames, by commit-to-present latency.
+
+        [[nodiscard]] auto mean_latency() const noexcept
+        {
+            return (presented == 0) ? std::chrono::nanoseconds{} : total_latency / static_cast<std::int64_t>(presented);
+        }
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const statistics& s)
+        {
+            using ms = std::chrono::duration<double, std::milli>;
+
+            return out << "presentation:{presented: " << s.presented << ", discarded: " << s.discarded << ", missed: " << s.missed
+                       << ", latency (ms): " << ms{s.min_latency}.count() << " min, " << ms{s.mean_latency()}.count() << " mean, "
+                       << ms{s.max_latency}.count() << " max}";
+        }
+    };
+
+    /// Constructor. @param clock Presentation clock of the display, as a clockid_t.
+    explicit presentation_log(int clock = CLOCK_MONOTONIC) noexcept : m_clock{clock} {}
+
+    presentation_log(const presentation_log&)            = delete;
+    presentation_log& operator=(const presentation_log&) = delete;
+
+    presentation_log(presentation_log&& other) noexcept
+        : m_clock{other.m_clock},
+          m_records{other.m_records},
+          m_next{std::exchange(other.m_next, 0)},
+          m_count{std::exchange(other.m_count, 0)},
+          m_pending{std::exchange(other.m_pending, {})},
+          m_pending_count{std::exchange(other.m_pending_count, 0)}
+    {
+        repoint();
+    }
+
+    presentation_log& operator=(presentation_log&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    /// Destructor. Destroys the pending feedback requests, whose events are then never received.
+    ~presentation_log() noexcept;
+
+    /**
+     * Tracks the feedback requested for the content being committed. Must be called right before wl_surface.commit.
+     * Takes ownership of the feedback object, which is destroyed once it delivered its event.
+     */
+    void track(struct wp_presentation_feedback* feedback) noexcept;
+
+    /// Called by the feedback events: records the outcome of a tracked commit and destroys its feedback object.
+    void complete(struct wp_presentation_feedback* feedback, record r) noexcept;
+
+    /// Forgets every record. Pending feedback requests are still tracked.
+    void clear() noexcept
+    {
+        m_next  = 0;
+        m_count = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_count; }
+
+    [[nodiscard]] std::size_t pending() const noexcept { return m_pending_count; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_count == 0; }
+
+    /// Returns a record, the oldest one being at index 0.
+    [[nodiscard]] const record& operator[](std::size_t index) const noexcept
+    {
+        return m_records[(m_next + max_records - m_count + index) % max_records];
+    }
+
+    /// Computes statistics over the records in the log.
+    [[nodiscard]] statistics stats() const noexcept;
+
+    [[nodiscard]] auto clock() const noexcept { return m_clock; }
+
+    void swap(presentation_log& other) noexcept
+    {
+        std::swap(m_clock, other.m_clock);
+        m_records.swap(other.m_records);
+        std::swap(m_next, other.m_next);
+        std::swap(m_count, other.m_count);
+        m_pending.swap(other.m_pending);
+        std::swap(m_pending_count, other.m_pending_count);
+
+        repoint();
+        other.repoint();
+    }
+
+    friend void swap(presentation_log& a, presentation_log& b) noexcept { a.swap(b); }
+
+private:
+
+    // wp_presentation_feedback also names the request creating these objects, hence the elaborated type specifiers
+    struct pending_commit
+    {
+        struct wp_presentation_feedback* feedback = nullptr;
+        std::chrono::nanoseconds         commit   = {};
+    };
+
+    /// Points the user data of the pending feedback objects to this object.
+    void repoint() noexcept;
+
+    int                                     m_clock         = CLOCK_MONOTONIC;
+    std::array<record, max_records>         m_records       = {};
+    std::size_t                             m_next          = 0; ///< Index the next record is written at.
+    std::size_t                             m_count         = 0;
+    std::array<pending_commit, max_pending> m_pending       = {};
+    std::size_t                             m_pending_count = 0;
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PRESENTATION_LOG_HPP
@@ -0,0 +1,232 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "protocol_stats.hpp"
+#include "wp/generated/presentation-time-client-protocol.hpp"
+#include "xdg/generated/shell-client-protocol.hpp"
+#include "zxdg/generated/decoration-client-protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland::protocol_stats
+{
+
+namespace
+{
+
+using counter = std::atomic<std::uint64_t>;
+
+/// Counters of the process. Every access is relaxed: they are statistics, not synchronisation.
+struct state
+{
+    std::array<std::array<counter, max_opcodes>, interface_count> requests = {};
+    std::array<std::array<counter, max_opcodes>, interface_count> events   = {};
+
+    counter flushes       = 0;
+    counter bytes_flushed = 0;
+
+    counter roundtrips        = 0;
+    counter roundtrip_time_ns = 0;
+
+    counter waits        = 0;
+    counter wait_time_ns = 0;
+};
+
+state& counters_of_process() noexcept
+{
+    static state s = {};
+    return s;
+}
+
+constexpr std::array<const wl_interface*, interface_count> interfaces = {
+    &wl_display_interface,
+    &wl_registry_interface,
+    &wl_callback_interface,
+    &wl_compositor_interface,
+    &wl_subcompositor_interface,
+    &wl_surface_interface,
+    &wl_shm_interface,
+    &wl_shm_pool_interface,
+    &wl_buffer_interface,
+    &wl_output_interface,
+    &wl_seat_interface,
+    &wl_pointer_interface,
+    &wl_keyboard_interface,
+    &xdg_wm_base_interface,
+    &xdg_surface_interface,
+    &xdg_toplevel_interface,
+    &zxdg_decoration_manager_v1_interface,
+    &zxdg_toplevel_decoration_v1_interface,
+    &wp_presentation_interface,
+    &wp_presentation_feedback_interface,
+};
+
+[[nodiscard]] constexpr std::size_t index(interface i) noexcept { return static_cast<std::size_t>(i); }
+
+[[nodiscard]] constexpr std::size_t clamp(std::size_t opcode) noexcept { return std::min(opcode, max_opcodes - 1); }
+
+void add(counter& c, std::uint64_t value = 1) noexcept { c.fetch_add(value, std::memory_order_relaxed); }
+
+[[nodiscard]] std::uint64_t load(const counter& c) noexcept { return c.load(std::memory_order_relaxed); }
+
+[[nodiscard]] std::uint64_t total(const counters::table& t) noexcept
+{
+    std::uint64_t result = 0;
+
+    for(const auto& opcodes : t)
+    {
+        for(const auto n : opcodes)
+        {
+            result += n;
+        }
+    }
+
+    return result;
+}
+
+/// Returns the name of a message of a table, or "?" past its end.
+[[nodiscard]] std::string_view message_name(const wl_message* messages, int count, std::size_t opcode) noexcept
+{
+    return (opcode < static_cast<std::size_t>(count)) ? messages[opcode].name : "?";
+}
+
+} // namespace
+
+[[nodiscard]] const wl_interface& describe(interface i) noexcept { return *interfaces.at(index(i)); }
+
+[[nodiscard]] std::string_view name(interface i) noexcept { return describe(i).name; }
+
+[[nodiscard]] std::string_view request_name(interface i, std::size_t opcode) noexcept
+{
+    const auto& d = describe(i);
+    return message_name(d.methods, d.method_count, opcode);
+}
+
+[[nodiscard]] std::string_view event_name(interface i, std::size_t opcode) noexcept
+{
+    const auto& d = describe(i);
+    return message_name(d.events, d.event_count, opcode);
+}
+
+[[nodiscard]] std::uint64_t counters::total_requests() const noexcept { return total(requests); }
+
+[[nodiscard]] std::uint64_t counters::total_events() const noexcept { return total(events); }
+
+void record_request(interface i, std::uint32_t opcode) noexcept { add(counters_of_process().requests[index(i)][clamp(opcode)]); }
+
+void record_event(interface i, std::size_t listener_offset) noexcept
+{
+    // Listeners are structures of function pointers, one per event, in opcode order
+    using function = void (*)();
+    add(counters_of_process().events[index(i)][clamp(listener_offset / sizeof(function))]);
+}
+
+void record_flush(int result) noexcept
+{
+    if(result > 0)
+    {
+        auto& s = counters_of_process();
+
+        add(s.flushes);
+        add(s.bytes_flushed, static_cast<std::uint64_t>(result));
+    }
+}
+
+int flush(wl_display* display) noexcept
+{
+    const int result = wl_display_flush(display);
+    record_flush(result);
+
+    return result;
+}
+
+void record_roundtrip(std::chrono::nanoseconds blocked) noexcept
+{
+    auto& s = counters_of_process();
+
+    add(s.requests[index(interface::wl_display)][WL_DISPLAY_SYNC]);
+    add(s.roundtrips);
+    add(s.roundtrip_time_ns, static_cast<std::uint64_t>(blocked.count()));
+}
+
+void record_wait(std::chrono::nanoseconds blocked) noexcept
+{
+    auto& s = counters_of_process();
+
+    add(s.waits);
+    add(s.wait_time_ns, static_cast<std::uint64_t>(blocked.count()));
+}
+
+[[nodiscard]] counters snapshot() noexcept
+{
+    const auto& s = counters_of_process();
+
+    counters result = {};
+
+    for(std::size_t i = 0; i < interface_count; ++i)
+    {
+        for(std::size_t op = 0; op < max_opcodes; ++op)
+        {
+            result.requests[i][op] = load(s.requests[i][op]);
+            result.events[i][op]   = load(s.events[i][op]);
+        }
+    }
+
+    result.flushes        = load(s.flushes);
+    result.bytes_flushed  = load(s.bytes_flushed);
+    result.roundtrips     = load(s.roundtrips);
+    result.roundtrip_time = std::chrono::nanoseconds{load(s.roundtrip_time_ns)};
+    result.waits          = load(s.waits);
+    result.wait_time      = std::chrono::nanoseconds{load(s.wait_time_ns)};
+
+    return result;
+}
+
+void reset() noexcept
+{
+    auto& s = counters_of_process();
+
+    for(std::size_t i = 0; i < interface_count; ++i)
+    {
+        for(std::size_t op = 0; op < max_opcodes; ++op)
+        {
+            s.requests[i][op].store(0, std::memory_order_relaxed);
+            s.events[i][op].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    for(auto* c : {&s.flushes, &s.bytes_flushed, &s.roundtrips, &s.roundtrip_time_ns, &s.waits, &s.wait_time_ns})
+    {
+        c->store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland::protocol_stats
@@ -0,0 +1,288 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PROTOCOL_STATS_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PROTOCOL_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+struct wl_interface;
+
+struct wl_display;
+struct wl_registry;
+struct wl_callback;
+struct wl_compositor;
+struct wl_subcompositor;
+struct wl_surface;
+struct wl_shm;
+struct wl_shm_pool;
+struct wl_buffer;
+struct wl_output;
+struct wl_seat;
+struct wl_pointer;
+struct wl_keyboard;
+struct xdg_wm_base;
+struct xdg_surface;
+struct xdg_toplevel;
+struct zxdg_decoration_manager_v1;
+struct zxdg_toplevel_decoration_v1;
+struct wp_presentation;
+struct wp_presentation_feedback;
+
+/**
+ * Counters of the Wayland traffic of the process: requests and events per interface and opcode, bytes flushed to the compositor, and time
+ * spent blocked on it. Meant to be left on in production, unlike WAYLAND_DEBUG: recording is a relaxed atomic increment.
+ * libwayland-client has no hook for this. This library sends its requests through send, builds its listeners from counted, and flushes
+ * through flush before it dispatches or roundtrips. Requests sent by the application directly, and events of listeners it installs, are
+ * not counted.
+ */
+namespace fubuki::io::platform::linux_bsd::wayland::protocol_stats
+{
+
+/// Interfaces whose traffic is counted.
+enum class interface : std::uint8_t
+{
+    wl_display,
+    wl_registry,
+    wl_callback,
+    wl_compositor,
+    wl_subcompositor,
+    wl_surface,
+    wl_shm,
+    wl_shm_pool,
+    wl_buffer,
+    wl_output,
+    wl_seat,
+    wl_pointer,
+    wl_keyboard,
+    xdg_wm_base,
+    xdg_surface,
+    xdg_toplevel,
+    zxdg_decoration_manager_v1,
+    zxdg_toplevel_decoration_v1,
+    wp_presentation,
+    wp_presentation_feedback,
+    count,
+};
+
+inline constexpr std::size_t interface_count = static_cast<std::size_t>(interface::count);
+
+/// Interface of the proxies of a type, interface::wl_surface for wl_surface for example. interface::count for types that are not counted.
+template<typename proxy>
+inline constexpr interface interface_of = interface::count;
+
+template<> inline constexpr interface interface_of<wl_display>                  = interface::wl_display;
+template<> inline constexpr interface interface_of<wl_registry>                 = interface::wl_registry;
+template<> inline constexpr interface interface_of<wl_callback>                 = interface::wl_callback;
+template<> inline constexpr interface interface_of<wl_compositor>               = interface::wl_compositor;
+template<> inline constexpr interface interface_of<wl_subcompositor>            = interface::wl_subcompositor;
+template<> inline constexpr interface interface_of<wl_surface>                  = interface::wl_surface;
+template<> inline constexpr interface interface_of<wl_shm>                      = interface::wl_shm;
+template<> inline constexpr interface interface_of<wl_shm_pool>                 = interface::wl_shm_pool;
+template<> inline constexpr interface interface_of<wl_buffer>                   = interface::wl_buffer;
+template<> inline constexpr interface interface_of<wl_output>                   = interface::wl_output;
+template<> inline constexpr interface interface_of<wl_seat>                     = interface::wl_seat;
+template<> inline constexpr interface interface_of<wl_pointer>                  = interface::wl_pointer;
+template<> inline constexpr interface interface_of<wl_keyboard>                 = interface::wl_keyboard;
+template<> inline constexpr interface interface_of<xdg_wm_base>                 = interface::xdg_wm_base;
+template<> inline constexpr interface interface_of<xdg_surface>                 = interface::xdg_surface;
+template<> inline constexpr interface interface_of<xdg_toplevel>                = interface::xdg_toplevel;
+template<> inline constexpr interface interface_of<zxdg_decoration_manager_v1>  = interface::zxdg_decoration_manager_v1;
+template<> inline constexpr interface interface_of<zxdg_toplevel_decoration_v1> = interface::zxdg_toplevel_decoration_v1;
+template<> inline constexpr interface interface_of<wp_presentation>             = interface::wp_presentation;
+// The generated wp_presentation_feedback request hides the structure, hence the elaborated type
+template<> inline constexpr interface interface_of<struct wp_presentation_feedback> = interface::wp_presentation_feedback;
+
+/// Opcodes past this one are counted with the last one. No interface above has more requests or events.
+inline constexpr std::size_t max_opcodes = 16;
+
+/// Returns the description of an interface, whose request and event tables name the opcodes.
+[[nodiscard]] const wl_interface& describe(interface i) noexcept;
+
+/// Returns the name of an interface, as advertised by the registry.
+[[nodiscard]] std::string_view name(interface i) noexcept;
+
+/// Returns the name of a request of an interface.
+[[nodiscard]] std::string_view request_name(interface i, std::size_t opcode) noexcept;
+
+/// Returns the name of an event of an interface.
+[[nodiscard]] std::string_view event_name(interface i, std::size_t opcode) noexcept;
+
+/// Copy of the counters at some point in time.
+struct counters
+{
+    using table = std::array<std::array<std::uint64_t, max_opcodes>, interface_count>;
+
+    table requests = {}; ///< Requests sent, by interface and opcode.
+    table events   = {}; ///< Events dispatched, by interface and opcode.
+
+    std::uint64_t flushes       = 0; ///< Calls to wl_display_flush that sent something.
+    std::uint64_t bytes_flushed = 0; ///< Bytes sent by these calls. Roundtrips flush as well, see roundtrip_time.
+
+    std::uint64_t            roundtrips     = 0;  ///< Roundtrips, on any queue.
+    std::chrono::nanoseconds roundtrip_time = {}; ///< Time spent blocked in roundtrips.
+
+    std::uint64_t            waits     = 0;  ///< Waits of event_loop for the display or its other sources.
+    std::chrono::nanoseconds wait_time = {}; ///< Time spent in these waits.
+
+    [[nodiscard]] std::uint64_t total_requests() const noexcept;
+    [[nodiscard]] std::uint64_t total_events() const noexcept;
+
+    /// Prints the totals, then every non-zero counter with the name of its message.
+    template<typename char_type, typename traits = std::char_traits<char_type>>
+    friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const counters& c)
+    {
+        using ms = std::chrono::duration<double, std::milli>;
+
+        out << "protocol:{requests: " << c.total_requests() << ", events: " << c.total_events() << ", flushed: " << c.bytes_flushed
+            << " bytes in " << c.flushes << " flushes, roundtrips: " << c.roundtrips << " (" << ms{c.roundtrip_time}.count()
+            << " ms), waits: " << c.waits << " (" << ms{c.wait_time}.count() << " ms)";
+
+        for(std::size_t i = 0; i < interface_count; ++i)
+        {
+            const auto id = static_cast<interface>(i);
+
+            for(std::size_t op = 0; op < max_opcodes; ++op)
+            {
+                if(c.requests[i][op] != 0)
+                {
+                    out << "\n  -> " << name(id) << "." << request_name(id, op) << ": " << c.requests[i][op];
+                }
+
+                if(c.events[i][op] != 0)
+                {
+                    out << "\n  <- " << name(id) << "." << event_name(id, op) << ": " << c.events[i][op];
+                }
+            }
+        }
+
+        return out << "}";
+    }
+};
+
+/// Records a request, by its opcode as generated by wayland-scanner, WL_SURFACE_COMMIT for example.
+void record_request(interface i, std::uint32_t opcode) noexcept;
+
+/**
+ * Records an event, by the offset of its member in the listener of the interface: offsetof(wl_output_listener, mode) for example.
+ * Listeners list their events in opcode order.
+ */
+void record_event(interface i, std::size_t listener_offset) noexcept;
+
+/// Records the result of wl_display_flush: the number of bytes sent, or -1.
+void record_flush(int result) noexcept;
+
+/**
+ * Sends the buffered requests of a display and records the bytes sent. Functions that dispatch or roundtrip flush as well, without telling
+ * how much they sent: calling this first leaves them nothing to send.
+ * @returns The result of wl_display_flush.
+ */
+int flush(wl_display* display) noexcept;
+
+/**
+ * Sends a request and records it. The interface follows from the type of the proxy.
+ * @tparam opcode Opcode of the request, as generated by wayland-scanner: WL_SURFACE_COMMIT for wl_surface_commit for example.
+ * @returns What the request returns, the new proxy of a constructor for example.
+ */
+template<std::uint32_t opcode, typename request, typename proxy, typename... arguments>
+decltype(auto) send(request r, proxy* target, arguments&&... args) noexcept
+{
+    static_assert(interface_of<proxy> != interface::count, "The requests of this interface are not counted");
+
+    record_request(interface_of<proxy>, opcode);
+    return r(target, std::forward<arguments>(args)...);
+}
+
+namespace detail
+{
+
+/// Returns the offset of an event in its listener, in bytes.
+template<typename listener, typename function>
+[[nodiscard]] std::size_t offset_of(function listener::*event) noexcept
+{
+    static constexpr listener layout = {};
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto* const base  = reinterpret_cast<const std::byte*>(std::addressof(layout));
+    const auto* const field = reinterpret_cast<const std::byte*>(std::addressof(layout.*event));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    return static_cast<std::size_t>(field - base);
+}
+
+template<auto event, auto callback>
+struct counted_event;
+
+template<typename listener, typename proxy, typename... arguments, void (*listener::*event)(void*, proxy*, arguments...), auto callback>
+struct counted_event<event, callback>
+{
+    static_assert(interface_of<proxy> != interface::count, "The events of this interface are not counted");
+
+    static void handle(void* data, proxy* target, arguments... args) noexcept
+    {
+        record_event(interface_of<proxy>, offset_of(event));
+
+        if constexpr(callback != nullptr)
+        {
+            callback(data, target, args...);
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * Listener callback recording an event, then handling it with callback, if any. Listeners are built from it, as in
+ * wl_output_listener{.done = counted<&wl_output_listener::done, on_done>, ...}, so that no event of the interface goes uncounted.
+ * Events without a callback are only recorded, which also keeps the listener free of null entries.
+ */
+template<auto event, auto callback = nullptr>
+inline constexpr auto counted = &detail::counted_event<event, callback>::handle;
+
+/// Records a roundtrip, which sends a wl_display.sync request, and the time it blocked.
+void record_roundtrip(std::chrono::nanoseconds blocked) noexcept;
+
+/// Records a wait for events.
+void record_wait(std::chrono::nanoseconds blocked) noexcept;
+
+/// Returns a copy of the counters. Thread-safe, though counters recorded concurrently may or may not be included.
+[[nodiscard]] counters snapshot() noexcept;
+
+/// Resets every counter to zero.
+void reset() noexcept;
+
+} // namespace fubuki::io::platform::linux_bsd::wayland::protocol_stats
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_PROTOCOL_STATS_HPP
@@ -30,6 +30,7 @@
 #define FUBUKI_IO_PLATFORM_WAYLAND_REGISTRY_HPP
 
 #include "display.hpp"
+#include "protocol_stats.hpp"
 
 #include <expected>
 
@@ -49,7 +50,7 @@ public:
     {
     };
 
-    registry(wl_display* d) : m_handle{wl_display_get_registry(d)}
+    registry(wl_display* d) : m_handle{protocol_stats::send<WL_DISPLAY_GET_REGISTRY>(wl_display_get_registry, d)}
     {
         if(m_handle == nullptr)
         {
@@ -72,7 +73,7 @@ public:
     {
         registry result{token{}};
 
-        result.m_handle = wl_display_get_registry(d);
+        result.m_handle = protocol_stats::send<WL_DISPLAY_GET_REGISTRY>(wl_display_get_registry, d);
 
         if(not result)
         {
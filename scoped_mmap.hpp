@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <cassert>
 #include <expected>
+#include <optional>
 #include <span>
 #include <stdexcept>
 #include <utility>
@@ -130,6 +131,23 @@ public:
         return scoped_mmap{token{}, ptr, len};
     }
 
+    /**
+     * Gives the kernel advice about the use of a part of the region.
+     * @returns An instance of error if the call failed, for instance when the kernel does not support the advice.
+     * @see https://man7.org/linux/man-pages/man2/madvise.2.html
+     */
+    [[nodiscard]] std::optional<error> advise(int advice, size_type offset = 0, size_type count = std::dynamic_extent) const noexcept
+    {
+        const auto region = m_contents.subspan(offset, count);
+
+        if(madvise(region.data(), region.size(), advice) != 0)
+        {
+            return error{};
+        }
+
+        return {};
+    }
+
     [[nodiscard]] constexpr iterator         begin() const noexcept { return m_contents.begin(); }
     [[nodiscard]] constexpr iterator         end() const noexcept { return m_contents.end(); }
     [[nodiscard]] constexpr reverse_iterator rbegin() const noexcept { return m_contents.rbegin(); }
@@ -38,7 +38,11 @@ namespace fubuki::io::platform::linux_bsd::wayland::screen
 
 using properties = platform::screen_properties;
 
-[[nodiscard]] std::vector<properties> enumerate(display& p);
+/**
+ * Returns the properties of the outputs of a display, as last described by the compositor. Does not communicate with the compositor.
+ * Thread-safe: prefer output_list::screens to avoid the copy, or output_list::on_change to follow changes.
+ */
+[[nodiscard]] std::vector<properties> enumerate(const display& p);
 
 } // namespace fubuki::io::platform::linux_bsd::wayland::screen
 
@@ -65,6 +65,7 @@ struct screen_properties
     std::string         name           = {}; ///< Screen name. Note that it may not be displayable. Should not be relied on.
     rectangle2d         area           = {}; ///< Screen render area.
     std::uint32_t       refresh_rate   = {}; ///< Screen refresh rate in Hz.
+    std::uint32_t       scale          = 1;  ///< Ratio between the pixels of the screen and the logical coordinates of the windows it shows.
     std::vector<config> configurations = {}; ///< Supported configurations.
 
     [[nodiscard]] friend constexpr bool operator==(const screen_properties& a, const screen_properties& b) noexcept  = default;
@@ -77,6 +78,7 @@ struct screen_properties
         name.swap(other.name);
         area.swap(other.area);
         std::swap(refresh_rate, other.refresh_rate);
+        std::swap(scale, other.scale);
         configurations.swap(other.configurations);
     }
 
@@ -91,6 +93,8 @@ struct screen_properties
             << " area: " << i.area << "px^2"
             << "\t"
             << " refresh rate: " << i.refresh_rate << "Hz"
+            << "\t"
+            << " scale: " << i.scale
             << "\n"
             << "supported configurations:\n";
 
@@ -73,7 +73,10 @@ public:
     {
     };
 
-    seat(display& parent);
+    seat(display& parent) : seat{parent.globals()} {}
+
+    /// Constructor. Creates the input devices from the seat of a set of globals, event_queue::globals for example.
+    explicit seat(const display::global& globals) : m_components{keyboard{globals}, pointer{globals}} {}
 
     seat(const seat&)            = delete;
     seat& operator=(const seat&) = delete;
@@ -88,18 +91,20 @@ public:
 
     ~seat() noexcept = default;
 
-    [[nodiscard]] static std::expected<seat, any_call_info> make(display& parent) noexcept
+    [[nodiscard]] static std::expected<seat, any_call_info> make(display& parent) noexcept { return make(parent.globals()); }
+
+    [[nodiscard]] static std::expected<seat, any_call_info> make(const display::global& globals) noexcept
     {
-        auto kb = keyboard::make(parent);
+        auto kb = keyboard::make(globals);
 
         if(not kb)
         {
             return std::unexpected{any_call_info{}};
         }
 
-        auto p = pointer::make(parent);
+        auto p = pointer::make(globals);
 
-        if(not kb)
+        if(not p)
         {
             return std::unexpected{any_call_info{}};
         }
@@ -0,0 +1,193 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "shm_arena.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+constexpr std::size_t page_size = 4096;
+
+[[nodiscard]] constexpr std::size_t round_up(std::size_t value, std::size_t alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+[[nodiscard]]
+auto shm_arena::allocate(std::size_t size_bytes) noexcept -> std::expected<block, any_call_info>
+{
+    // Regions are page-aligned so that they never share a page with another owner
+    const auto size = round_up(std::max(std::size_t{1}, size_bytes), page_size);
+
+    const std::scoped_lock<std::mutex> lock{m_sync};
+
+    for(auto& c : m_chunks)
+    {
+        const auto it = std::ranges::find_if(c->free_list, [size](const auto& region) noexcept { return region.second >= size; });
+
+        if(it == c->free_list.end())
+        {
+            continue;
+        }
+
+        const auto [offset, available] = *it;
+
+        // The remainder is inserted first: if that fails, the free list is left as it was
+        if(available > size)
+        {
+            try
+            {
+                c->free_list.emplace(offset + size, available - size);
+            }
+            catch(const std::bad_alloc&)
+            {
+                return std::unexpected{any_call_info{}};
+            }
+        }
+
+        c->free_list.erase(it);
+
+        c->used += size;
+        m_allocations += 1;
+
+        return block{*this, *c, offset, size};
+    }
+
+    // The format of the pool only determines its size: buffers allocated from the arena have their own
+    constexpr auto format        = WL_SHM_FORMAT_ARGB8888;
+    constexpr auto format_stride = *bytes_per_pixel(format);
+
+    const auto chunk_size = round_up(std::max(size, m_info.chunk_size_bytes), page_size);
+
+    auto pool = shm_pool::make(m_globals,
+                               {.width = chunk_size / format_stride, .height = 1, .layers = 1, .format = format, .backing = m_info.backing});
+
+    if(not pool)
+    {
+        std::cerr << "Failed to create a new shm_arena pool\n" << std::flush;
+        return std::unexpected{any_call_info{}};
+    }
+
+    chunk* c = nullptr;
+
+    // Built aside, so that a failure destroys the new pool and leaves the arena as it was
+    try
+    {
+        auto next = std::make_unique<chunk>(chunk{.pool = *std::move(pool), .free_list = {}, .used = size});
+
+        if(chunk_size > size)
+        {
+            next->free_list.emplace(size, chunk_size - size);
+        }
+
+        c = m_chunks.emplace_back(std::move(next)).get();
+    }
+    catch(const std::bad_alloc&)
+    {
+        std::cerr << "Failed to create a new shm_arena pool\n" << std::flush;
+        return std::unexpected{any_call_info{}};
+    }
+
+    m_allocations += 1;
+
+    return block{*this, *c, 0, size};
+}
+
+void shm_arena::deallocate(chunk& c, std::size_t offset, std::size_t size) noexcept
+{
+    const std::scoped_lock<std::mutex> lock{m_sync};
+
+    c.used -= size;
+    m_allocations -= 1;
+
+    try
+    {
+        const auto it = c.free_list.emplace(offset, size).first;
+
+        // Merge with the following region
+        if(const auto next = std::next(it); next != c.free_list.end() and it->first + it->second == next->first)
+        {
+            it->second += next->second;
+            c.free_list.erase(next);
+        }
+
+        // Merge with the preceding region
+        if(it != c.free_list.begin())
+        {
+            if(const auto previous = std::prev(it); previous->first + previous->second == it->first)
+            {
+                previous->second += it->second;
+                c.free_list.erase(it);
+            }
+        }
+    }
+    catch(const std::bad_alloc&)
+    {
+        // Called from the destructor of blocks: the region is lost until its chunk is emptied, rather than terminating
+        std::cerr << "Failed to give a region back to its shm_arena pool\n" << std::flush;
+    }
+
+    // Keep the last pool alive, it will most likely be needed again
+    if(c.used == 0 and m_chunks.size() > 1)
+    {
+        std::erase_if(m_chunks, [&c](const auto& ptr) noexcept { return ptr.get() == std::addressof(c); });
+    }
+}
+
+[[nodiscard]]
+auto shm_arena::stats() const noexcept -> statistics
+{
+    const std::scoped_lock<std::mutex> lock{m_sync};
+
+    statistics result = {.allocations = m_allocations};
+
+    for(const auto& c : m_chunks)
+    {
+        result.pools += 1;
+        result.capacity_bytes += c->pool.size_bytes();
+        result.used_bytes += c->used;
+
+        for(const auto& [offset, size] : c->free_list)
+        {
+            result.largest_free_bytes = std::max(result.largest_free_bytes, size);
+        }
+    }
+
+    return result;
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
@@ -0,0 +1,215 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_ARENA_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_ARENA_HPP
+
+#include "display.hpp"
+#include "shm_pool.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * A set of large shm_pool shared by several owners, which sub-allocate regions from them.
+ * Regions are handed out from a first-fit free-list. Adjacent free regions are merged on release, and pools that become empty are
+ * destroyed, except for the last one.
+ * This class is thread-safe.
+ */
+class shm_arena
+{
+    struct chunk
+    {
+        shm_pool                           pool;
+        std::map<std::size_t, std::size_t> free_list = {}; ///< Offset -> size of each free region, sorted by offset.
+        std::size_t                        used      = 0;  ///< Number of bytes allocated in this chunk.
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    struct information
+    {
+        /// Default size of each pool of the arena, in bytes. Regions larger than this get a pool of their own.
+        std::size_t chunk_size_bytes = std::size_t{64} << 20U;
+
+        /// Backing of each pool of the arena.
+        shm_pool::backing_policy backing = {};
+    };
+
+    /// Snapshot of the arena usage.
+    struct statistics
+    {
+        std::size_t pools              = 0; ///< Number of wl_shm_pool created by the arena.
+        std::size_t allocations        = 0; ///< Number of live regions.
+        std::size_t capacity_bytes     = 0; ///< Total size of the pools.
+        std::size_t used_bytes         = 0; ///< Total size of the live regions.
+        std::size_t largest_free_bytes = 0; ///< Size of the largest region that can be allocated without creating a new pool.
+
+        /// Ratio of the capacity that is allocated, in [0, 1].
+        [[nodiscard]] constexpr double utilisation() const noexcept
+        {
+            return capacity_bytes == 0 ? 0.0 : static_cast<double>(used_bytes) / static_cast<double>(capacity_bytes);
+        }
+
+        /// Ratio of the free memory that cannot be handed out as a single region, in [0, 1]. 0 means the free memory is contiguous.
+        [[nodiscard]] constexpr double fragmentation() const noexcept
+        {
+            const auto free_bytes = capacity_bytes - used_bytes;
+            return free_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(largest_free_bytes) / static_cast<double>(free_bytes);
+        }
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const statistics& s)
+        {
+            return out << "shm_arena:{"
+                       << "pools: " << s.pools << "\t"
+                       << "allocations: " << s.allocations << "\t"
+                       << "capacity: " << s.capacity_bytes << "B\t"
+                       << "used: " << s.used_bytes << "B\t"
+                       << "utilisation: " << s.utilisation() << "\t"
+                       << "fragmentation: " << s.fragmentation() << "\t"
+                       << "}";
+        }
+    };
+
+    /// A region of a pool of the arena. The region is given back to the arena upon destruction.
+    class block
+    {
+        friend class shm_arena;
+
+    public:
+
+        block(const block&)            = delete;
+        block& operator=(const block&) = delete;
+
+        block(block&& other) noexcept
+            : m_parent{std::exchange(other.m_parent, nullptr)},
+              m_chunk{std::exchange(other.m_chunk, nullptr)},
+              m_offset{std::exchange(other.m_offset, 0)},
+              m_size{std::exchange(other.m_size, 0)}
+        {
+        }
+
+        block& operator=(block&& other) noexcept
+        {
+            swap(other);
+            return *this;
+        }
+
+        ~block() noexcept
+        {
+            if(m_parent != nullptr)
+            {
+                m_parent->deallocate(*m_chunk, m_offset, m_size);
+            }
+        }
+
+        /// Arena this region belongs to.
+        [[nodiscard]] shm_arena* arena() const noexcept { return m_parent; }
+
+        /// Pool containing this region.
+        [[nodiscard]] shm_pool&       pool() noexcept { return m_chunk->pool; }
+        [[nodiscard]] const shm_pool& pool() const noexcept { return m_chunk->pool; }
+
+        /// Offset of the region in the pool, in bytes.
+        [[nodiscard]] auto offset() const noexcept { return m_offset; }
+
+        /// Size of the region, in bytes.
+        [[nodiscard]] auto size_bytes() const noexcept { return m_size; }
+
+        void swap(block& other) noexcept
+        {
+            std::swap(m_parent, other.m_parent);
+            std::swap(m_chunk, other.m_chunk);
+            std::swap(m_offset, other.m_offset);
+            std::swap(m_size, other.m_size);
+        }
+
+        friend void swap(block& a, block& b) noexcept { a.swap(b); }
+
+    private:
+
+        block(shm_arena& parent, chunk& c, std::size_t offset, std::size_t size) noexcept
+            : m_parent{std::addressof(parent)}, m_chunk{std::addressof(c)}, m_offset{offset}, m_size{size}
+        {
+        }
+
+        shm_arena*  m_parent = nullptr;
+        chunk*      m_chunk  = nullptr;
+        std::size_t m_offset = 0;
+        std::size_t m_size   = 0;
+    };
+
+    shm_arena(const display::global& g, information i) noexcept : m_globals{g}, m_info{i} {}
+
+    shm_arena(const display::global& g) noexcept : shm_arena{g, information{}} {}
+
+    shm_arena(const shm_arena&)            = delete;
+    shm_arena& operator=(const shm_arena&) = delete;
+    shm_arena(shm_arena&&)                 = delete;
+    shm_arena& operator=(shm_arena&&)      = delete;
+
+    ~shm_arena() noexcept = default;
+
+    /**
+     * Allocates a region of at least size_bytes bytes. A new pool is created if no free region is large enough.
+     * @returns The region, or an instance of any_call_info if a new pool could not be created.
+     */
+    [[nodiscard]] std::expected<block, any_call_info> allocate(std::size_t size_bytes) noexcept;
+
+    [[nodiscard]] statistics stats() const noexcept;
+
+    [[nodiscard]] const auto& info() const noexcept { return m_info; }
+
+private:
+
+    void deallocate(chunk& c, std::size_t offset, std::size_t size) noexcept;
+
+    display::global                     m_globals     = {};
+    information                         m_info        = {};
+    mutable std::mutex                  m_sync        = {};
+    std::vector<std::unique_ptr<chunk>> m_chunks      = {};
+    std::size_t                         m_allocations = 0;
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_ARENA_HPP
@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "protocol_stats.hpp"
 #include "shm_buffer.hpp"
 
 #include <cassert>
@@ -36,23 +37,31 @@ namespace fubuki::io::platform::linux_bsd::wayland
 
 [[nodiscard]] std::optional<shm_buffer::any_call_info> shm_buffer::create(shm_pool& parent) noexcept
 {
-    constexpr std::size_t format_stride = 4; // 32-bit, 4 bytes
-    const auto            stride        = static_cast<std::int32_t>(width() * format_stride);
-    const auto            offset        = height() * width() * index() * format_stride;
+    if(not bytes_per_pixel(format()))
+    {
+        return any_call_info{};
+    }
+
+    // Past the end of the pool, the request is a protocol error, and the memory out of range
+    if(offset_bytes() + size_bytes() > parent.size_bytes())
+    {
+        return any_call_info{};
+    }
 
-    m_handle = wl_shm_pool_create_buffer(parent.handle(),
-                                         static_cast<std::int32_t>(offset),
-                                         static_cast<std::int32_t>(width()),
-                                         static_cast<std::int32_t>(height()),
-                                         stride,
-                                         information::format);
+    m_handle = protocol_stats::send<WL_SHM_POOL_CREATE_BUFFER>(wl_shm_pool_create_buffer,
+                                                               parent.handle(),
+                                                               static_cast<std::int32_t>(offset_bytes()),
+                                                               static_cast<std::int32_t>(width()),
+                                                               static_cast<std::int32_t>(height()),
+                                                               static_cast<std::int32_t>(stride()),
+                                                               format());
 
     if(m_handle == nullptr)
     {
         return any_call_info{};
     }
 
-    m_memory = parent.memory().subspan(offset, size_bytes());
+    m_memory = parent.memory().subspan(offset_bytes(), size_bytes());
 
     return {};
 }
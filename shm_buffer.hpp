@@ -29,6 +29,7 @@
 #ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_BUFFER_HPP
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_BUFFER_HPP
 
+#include "protocol_stats.hpp"
 #include "shm_pool.hpp"
 
 #include <cstddef>
@@ -51,11 +52,12 @@ public:
 
     struct information
     {
-        static constexpr auto format = WL_SHM_FORMAT_ARGB8888;
-
         /// Index of the image of the pool this buffer represents.
         std::size_t index = 0;
 
+        /// Offset of the first image in the pool, in bytes. Used to place buffers in a region of a shared pool.
+        std::size_t offset = 0;
+
         /// Width of the buffer.
         ///  If not provided, uses the weight specified in the parent pool information.
         /// If provided, this value is adjusted to be at least 1.
@@ -65,6 +67,10 @@ public:
         /// If not provided, uses the height specified in the parent pool information.
         /// If provided, this value is adjusted to be at least 1.
         std::optional<std::size_t> height = {};
+
+        /// Format of the buffer.
+        /// If not provided, uses the format specified in the parent pool information.
+        std::optional<wl_shm_format> format = {};
     };
 
     shm_buffer(shm_pool& parent, information i) : shm_buffer{token{}, parent, i}
@@ -95,7 +101,7 @@ public:
     {
         if(m_handle != nullptr)
         {
-            wl_buffer_destroy(m_handle);
+            protocol_stats::send<WL_BUFFER_DESTROY>(wl_buffer_destroy, m_handle);
         }
     }
 
@@ -116,13 +122,15 @@ public:
     [[nodiscard]] auto index() const noexcept{return m_info.index;}
     [[nodiscard]] auto width() const noexcept { return m_info.width.value_or(1); }
     [[nodiscard]] auto height() const noexcept { return m_info.height.value_or(1); }
+    [[nodiscard]] auto format() const noexcept { return m_info.format.value_or(WL_SHM_FORMAT_ARGB8888); }
 
-    [[nodiscard]] auto size_bytes() const noexcept
-    {
-        constexpr std::size_t format_stride = 4; // 32-bit, 4 bytes
+    /// Returns the size of a row, in bytes. Rows are tightly packed.
+    [[nodiscard]] auto stride() const noexcept { return width() * bytes_per_pixel(format()).value_or(0); }
 
-        return width() * height() * format_stride;
-    }
+    [[nodiscard]] auto size_bytes() const noexcept { return stride() * height(); }
+
+    /// Returns the offset of this buffer in its parent pool, in bytes.
+    [[nodiscard]] auto offset_bytes() const noexcept { return m_info.offset + size_bytes() * index(); }
 
     [[nodiscard]] auto*       handle() noexcept { return m_handle; }
     [[nodiscard]] const auto* handle() const noexcept { return m_handle; }
@@ -163,6 +171,11 @@ private:
         {
             m_info.height = parent.info().height;
         }
+
+        if(not m_info.format.has_value())
+        {
+            m_info.format = parent.info().format;
+        }
     }
 
     [[nodiscard]] std::optional<any_call_info> create(shm_pool& parent) noexcept;
@@ -0,0 +1,100 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_FORMAT_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_FORMAT_HPP
+
+#include <cstddef>
+#include <optional>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Returns the size of a pixel of a format, in bytes.
+ * @returns std::nullopt if the format is not supported, for instance planar YUV formats or formats with 24-bit pixels.
+ */
+[[nodiscard]] constexpr std::optional<std::size_t> bytes_per_pixel(wl_shm_format f) noexcept
+{
+    switch(f)
+    {
+        case WL_SHM_FORMAT_ARGB8888:
+        case WL_SHM_FORMAT_XRGB8888:
+        case WL_SHM_FORMAT_ABGR8888:
+        case WL_SHM_FORMAT_XBGR8888:
+        case WL_SHM_FORMAT_RGBA8888:
+        case WL_SHM_FORMAT_RGBX8888:
+        case WL_SHM_FORMAT_BGRA8888:
+        case WL_SHM_FORMAT_BGRX8888:
+        case WL_SHM_FORMAT_ARGB2101010:
+        case WL_SHM_FORMAT_XRGB2101010:
+        case WL_SHM_FORMAT_ABGR2101010:
+        case WL_SHM_FORMAT_XBGR2101010:
+        case WL_SHM_FORMAT_RGBA1010102:
+        case WL_SHM_FORMAT_RGBX1010102:
+        case WL_SHM_FORMAT_BGRA1010102:
+        case WL_SHM_FORMAT_BGRX1010102: return 4;
+
+        case WL_SHM_FORMAT_RGB565:
+        case WL_SHM_FORMAT_BGR565:
+        case WL_SHM_FORMAT_ARGB4444:
+        case WL_SHM_FORMAT_XRGB4444:
+        case WL_SHM_FORMAT_ARGB1555:
+        case WL_SHM_FORMAT_XRGB1555: return 2;
+
+        default: return std::nullopt;
+    }
+}
+
+/// Returns true if a format has no alpha channel. The compositor does not need to blend surfaces using such formats.
+[[nodiscard]] constexpr bool is_opaque(wl_shm_format f) noexcept
+{
+    switch(f)
+    {
+        case WL_SHM_FORMAT_XRGB8888:
+        case WL_SHM_FORMAT_XBGR8888:
+        case WL_SHM_FORMAT_RGBX8888:
+        case WL_SHM_FORMAT_BGRX8888:
+        case WL_SHM_FORMAT_XRGB2101010:
+        case WL_SHM_FORMAT_XBGR2101010:
+        case WL_SHM_FORMAT_RGBX1010102:
+        case WL_SHM_FORMAT_BGRX1010102:
+        case WL_SHM_FORMAT_RGB565:
+        case WL_SHM_FORMAT_BGR565:
+        case WL_SHM_FORMAT_XRGB4444:
+        case WL_SHM_FORMAT_XRGB1555: return true;
+
+        default: return false;
+    }
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SHM_FORMAT_HPP
@@ -27,13 +27,17 @@
  */
 
 #include "file_descriptor.hpp"
+#include "protocol_stats.hpp"
 #include "scoped_mmap.hpp"
 #include "shm_pool.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string_view>
+#include <tuple>
+#include <utility>
 
 #include <fcntl.h>
 #include <unistd.h>
@@ -55,6 +59,18 @@ struct free_c_storage
 template<typename T>
 using unique_c_ptr = std::unique_ptr<T, free_c_storage<T>>;
 
+// Default huge page size on x86-64, and on arm64 with 4 KiB pages. MFD_HUGETLB uses the default size.
+constexpr std::size_t huge_page_size = std::size_t{2} << 20U;
+
+[[nodiscard]] constexpr std::size_t round_up(std::size_t value, std::size_t granularity) noexcept
+{
+    return (value + granularity - 1) / granularity * granularity;
+}
+
+// Pools may be created from any thread, see shm_arena
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<std::size_t> next_id = 1;
+
 } // anonymous namespace
 
 [[nodiscard]]
@@ -66,6 +82,18 @@ std::optional<shm_pool::any_call_info> shm_pool::create() noexcept
         return any_call_info{};
     }
 
+    const auto format_stride = bytes_per_pixel(m_info.format);
+
+    if(not format_stride)
+    {
+        std::cerr << "Unsupported shm_pool format\n" << std::flush;
+        return any_call_info{};
+    }
+
+    using pages = backing_policy::pages;
+
+    m_size_bytes = m_info.width * m_info.height * *format_stride * m_info.layers;
+
     const unique_c_ptr<char> current_dir{get_current_dir_name()};
 
     if(not current_dir)
@@ -74,8 +102,32 @@ std::optional<shm_pool::any_call_info> shm_pool::create() noexcept
         return any_call_info{};
     }
 
+    const std::string_view fallback_path          = current_dir.get();
+    const std::string_view fallback_name_template = "fubuki-io-wayland-shm_pool";
+
+    if(m_info.backing.page_size == pages::huge)
     {
-        auto fd = file_descriptor::make_anonymous(size_bytes(), std::string_view{current_dir.get()}, "fubuki-io-wayland-shm_pool");
+        const auto huge_size = round_up(m_size_bytes, huge_page_size);
+
+        constexpr auto hint = file_descriptor::anonymous_hint::memfd_hugetlb;
+
+        if(auto fd = file_descriptor::make_anonymous(huge_size, fallback_path, fallback_name_template, hint))
+        {
+            m_fd         = *std::move(fd);
+            m_size_bytes = huge_size;
+        }
+        else
+        {
+            // Usually means that no huge page was reserved (vm.nr_hugepages)
+            std::cerr << "Huge pages unavailable, falling back to transparent huge pages\n" << std::flush;
+            m_info.backing.page_size = pages::transparent_huge;
+        }
+    }
+
+    if(m_info.backing.page_size != pages::huge)
+    {
+        auto fd = file_descriptor::make_anonymous(
+            size_bytes(), fallback_path, fallback_name_template, file_descriptor::anonymous_hint::memfd, m_info.backing.allocation);
 
         if(not fd)
         {
@@ -86,8 +138,13 @@ std::optional<shm_pool::any_call_info> shm_pool::create() noexcept
         m_fd = *std::move(fd);
     }
 
+    // Transparent huge pages must be advised before the pages are faulted in, prefault() takes care of them below
+    const bool populate = m_info.backing.prefault and m_info.backing.page_size != pages::transparent_huge;
+
     {
-        auto mmap_scope = scoped_mmap::make(nullptr, size_bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd.get().value, 0);
+        const int flags = MAP_SHARED | (populate ? MAP_POPULATE : 0);
+
+        auto mmap_scope = scoped_mmap::make(nullptr, size_bytes(), PROT_READ | PROT_WRITE, flags, m_fd.get().value, 0);
 
         if(not mmap_scope)
         {
@@ -98,14 +155,40 @@ std::optional<shm_pool::any_call_info> shm_pool::create() noexcept
         m_memory = *std::move(mmap_scope);
     }
 
-    m_handle = wl_shm_create_pool(m_globals.shm, m_fd.get().value, static_cast<std::int32_t>(size_bytes()));
+    advise(0, size_bytes());
+
+    if(m_info.backing.prefault and not populate)
+    {
+        prefault(0, size_bytes());
+    }
+
+    m_handle = protocol_stats::send<WL_SHM_CREATE_POOL>(wl_shm_create_pool, m_globals.shm, m_fd.get().value, static_cast<std::int32_t>(size_bytes()));
 
     if(m_handle == nullptr)
     {
         return any_call_info{};
     }
 
+    m_id = next_id.fetch_add(1, std::memory_order_relaxed);
+
     return {};
 }
 
+void shm_pool::advise(std::size_t offset, std::size_t count) const noexcept
+{
+    if(m_info.backing.page_size == backing_policy::pages::transparent_huge)
+    {
+        // Only effective if /sys/kernel/mm/transparent_hugepage/shmem_enabled is "advise" or "always"
+        std::ignore = m_memory.advise(MADV_HUGEPAGE, offset, count);
+    }
+}
+
+void shm_pool::prefault([[maybe_unused]] std::size_t offset, [[maybe_unused]] std::size_t count) const noexcept
+{
+#if defined(MADV_POPULATE_WRITE)
+    // Requires Linux 5.14. Failing is harmless: pages fault in on first access instead
+    std::ignore = m_memory.advise(MADV_POPULATE_WRITE, offset, count);
+#endif
+}
+
 } // namespace fubuki::io::platform::linux_bsd::wayland
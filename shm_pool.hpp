@@ -31,7 +31,9 @@
 
 #include "display.hpp"
 #include "file_descriptor.hpp"
+#include "protocol_stats.hpp"
 #include "scoped_mmap.hpp"
+#include "shm_format.hpp"
 
 #include <cstddef>
 #include <optional>
@@ -54,18 +56,46 @@ public:
     {
     };
 
-    struct information
+    /// How the memory of a pool is backed. The defaults reserve every page upfront, and let them fault in on first access.
+    struct backing_policy
     {
-        static constexpr auto format = WL_SHM_FORMAT_ARGB8888;
+        enum class pages
+        {
+            normal,           ///< Regular pages.
+            transparent_huge, ///< Regular pages, advised with MADV_HUGEPAGE so that the kernel may back them with transparent huge pages.
+            huge,             ///< Pages of the hugetlb pool (MFD_HUGETLB). Falls back to transparent_huge if no huge page is available.
+        };
+
+        file_descriptor::allocation allocation = file_descriptor::allocation::reserve;
+        pages                       page_size  = pages::normal;
+
+        /// Faults every page in when the pool is created (MAP_POPULATE), instead of during the first frames drawn into it.
+        bool prefault = false;
 
+        [[nodiscard]] friend constexpr bool operator==(const backing_policy& a, const backing_policy& b) noexcept = default;
+        [[nodiscard]] friend constexpr bool operator!=(const backing_policy& a, const backing_policy& b) noexcept = default;
+    };
+
+    struct information
+    {
         std::size_t width  = 1;
         std::size_t height = 1;
         std::size_t layers = 2;
-        // Only format supported: ARGB8888
+
+        /// Format of the images of the pool, which determines their size. Must be supported by the display, see display::supports.
+        wl_shm_format format = WL_SHM_FORMAT_ARGB8888;
+
+        /// Backing of the pool. After creation, info().backing.page_size reflects the pages actually in use.
+        backing_policy backing = {};
     };
 
     shm_pool(display& parent, information i) : m_globals{parent.globals()}, m_info{i}
     {
+        if(not parent.supports(i.format))
+        {
+            throw std::runtime_error("Pixel format not supported by the compositor");
+        }
+
         if(const auto error = create())
         {
             throw std::runtime_error("");
@@ -80,7 +110,9 @@ public:
           m_memory{std::move(other.m_memory)},
           m_info{other.m_info},
           m_globals{other.m_globals},
-          m_handle{std::exchange(other.m_handle, nullptr)}
+          m_size_bytes{std::exchange(other.m_size_bytes, 0)},
+          m_handle{std::exchange(other.m_handle, nullptr)},
+          m_id{std::exchange(other.m_id, 0)}
     {
     }
 
@@ -94,13 +126,23 @@ public:
     {
         if(m_handle != nullptr)
         {
-            wl_shm_pool_destroy(m_handle);
+            protocol_stats::send<WL_SHM_POOL_DESTROY>(wl_shm_pool_destroy, m_handle);
         }
     }
 
     [[nodiscard]] static std::expected<shm_pool, any_call_info> make(display& parent, information i) noexcept
     {
-        auto result = shm_pool{token{}, parent.globals(), i};
+        return make(parent.globals(), i);
+    }
+
+    [[nodiscard]] static std::expected<shm_pool, any_call_info> make(const display::global& g, information i) noexcept
+    {
+        if(not display::supports(g, i.format))
+        {
+            return std::unexpected{any_call_info{}};
+        }
+
+        auto result = shm_pool{token{}, g, i};
 
         if(const auto error = result.create())
         {
@@ -112,16 +154,15 @@ public:
 
     [[nodiscard]] const auto& info() const noexcept { return m_info; }
 
-    [[nodiscard]] auto size_bytes() const noexcept
-    {
-        constexpr std::size_t format_stride = 4; // 32-bit, 4 bytes
-
-        return m_info.width * m_info.height * format_stride * m_info.layers;
-    }
+    /// Returns the size of the pool in bytes. This is at least the size required by info(), and more when backed by huge pages.
+    [[nodiscard]] auto size_bytes() const noexcept { return m_size_bytes; }
 
     [[nodiscard]] auto*       handle() noexcept { return m_handle; }
     [[nodiscard]] const auto* handle() const noexcept { return m_handle; }
 
+    /// Returns an identifier of the pool, unique in the process. Unlike the address of the pool, it is never reused.
+    [[nodiscard]] auto id() const noexcept { return m_id; }
+
     [[nodiscard]] const auto& memory() const noexcept { return m_memory; }
 
     [[nodiscard]] const auto& globals() const noexcept { return m_globals; }
@@ -132,7 +173,9 @@ public:
         m_memory.swap(other.m_memory);
         m_globals.swap(other.m_globals);
         std::swap(m_info, other.m_info);
+        std::swap(m_size_bytes, other.m_size_bytes);
         std::swap(m_handle, other.m_handle);
+        std::swap(m_id, other.m_id);
     }
 
     friend void swap(shm_pool& a, shm_pool& b) noexcept { a.swap(b); }
@@ -149,11 +192,19 @@ private:
     [[nodiscard]]
     std::optional<any_call_info> create() noexcept;
 
-    file_descriptor m_fd      = {};
-    scoped_mmap     m_memory  = {};
-    display::global m_globals = {};
-    information     m_info    = {};
-    wl_shm_pool*    m_handle  = nullptr;
+    /// Applies the madvise hints of the backing policy to a range of the pool.
+    void advise(std::size_t offset, std::size_t count) const noexcept;
+
+    /// Faults in a range of the pool, for pools that could not be mapped with MAP_POPULATE.
+    void prefault(std::size_t offset, std::size_t count) const noexcept;
+
+    file_descriptor m_fd         = {};
+    scoped_mmap     m_memory     = {};
+    display::global m_globals    = {};
+    information     m_info       = {};
+    std::size_t     m_size_bytes = 0;
+    wl_shm_pool*    m_handle     = nullptr;
+    std::size_t     m_id         = 0;
 };
 
 } // namespace fubuki::io::platform::linux_bsd::wayland
@@ -0,0 +1,478 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "swapchain.hpp"
+#include "protocol_stats.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+namespace callback::buffer
+{
+
+void release(void* data, wl_buffer* /*buffer*/) noexcept
+{
+    auto* const state = static_cast<swapchain::status*>(data);
+    *state            = swapchain::status::free;
+}
+
+} // namespace callback::buffer
+
+namespace listener
+{
+
+constexpr wl_buffer_listener buffer{.release = protocol_stats::counted<&wl_buffer_listener::release, callback::buffer::release>};
+
+} // namespace listener
+
+} // namespace
+
+void swapchain::listen(slot& s) noexcept
+{
+    wl_buffer_add_listener(s.buffer.handle(), std::addressof(listener::buffer), std::addressof(s.state));
+
+    // Buffers receive no event before they are attached, so moving them after their creation is race-free
+    if(m_info.queue != nullptr)
+    {
+        wl_proxy_set_queue(reinterpret_cast<wl_proxy*>(s.buffer.handle()), m_info.queue);
+    }
+}
+
+[[nodiscard]]
+auto swapchain::create(shm_pool& parent, std::size_t offset) noexcept -> std::optional<any_call_info>
+{
+    const auto count = layer_count(m_info.presentation);
+
+    m_slots.reserve(count);
+    m_ready.reserve(count);
+
+    m_pool = parent.id();
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        m_cache_stats.misses += 1;
+
+        auto buffer = shm_buffer::make(parent,
+                                       {.index  = 0,
+                                        .offset = offset + (i * layer_size_bytes()),
+                                        .width  = m_info.width,
+                                        .height = m_info.height,
+                                        .format = m_info.format});
+
+        if(not buffer)
+        {
+            return any_call_info{};
+        }
+
+        m_slots.push_back(slot{.buffer = *std::move(buffer), .state = status::free, .pool = parent.id()});
+    }
+
+    // Only register the listeners once the vector does not reallocate anymore
+    for(auto& s : m_slots)
+    {
+        listen(s);
+    }
+
+    return {};
+}
+
+[[nodiscard]]
+auto swapchain::create(shm_arena& parent) noexcept -> std::optional<any_call_info>
+{
+    if(layer_size_bytes() == 0)
+    {
+        return any_call_info{};
+    }
+
+    auto region = parent.allocate(layer_size_bytes() * layer_count(m_info.presentation));
+
+    if(not region)
+    {
+        return any_call_info{};
+    }
+
+    m_block = *std::move(region);
+
+    prefault();
+
+    return create(m_block->pool(), m_block->offset());
+}
+
+void swapchain::prefault() noexcept
+{
+    if(not m_info.background_prefault or not m_block)
+    {
+        return;
+    }
+
+    // Not being able to start the worker only means that pages fault in on first access
+    if(auto worker = prefault_worker::make(m_block->pool().memory().subspan(m_block->offset(), m_block->size_bytes())))
+    {
+        m_prefault = *std::move(worker);
+    }
+}
+
+void swapchain::cache(slot&& s) noexcept
+{
+    auto& cached = m_cache.emplace_front(std::move(s));
+    wl_buffer_set_user_data(cached.buffer.handle(), std::addressof(cached.state));
+}
+
+[[nodiscard]]
+auto swapchain::rebuild(shm_pool& parent, std::size_t offset, const information& next) noexcept -> std::optional<any_call_info>
+{
+    const auto previous      = std::exchange(m_info, next);
+    const auto previous_pool = std::exchange(m_pool, parent.id());
+    const auto count         = m_slots.size();
+
+    std::vector<wl_buffer*> handles;
+    handles.reserve(count);
+
+    // Keep the current buffers around, busy ones included: the cache keeps tracking their release
+    for(auto& s : m_slots)
+    {
+        handles.push_back(s.buffer.handle());
+        cache(std::move(s));
+    }
+
+    m_slots.clear();
+
+    // Built aside, so that a failure leaves the current layers in place. Reserved: the release listeners point into the vector
+    std::vector<slot> slots;
+    slots.reserve(count);
+
+    bool failed = false;
+
+    for(std::size_t i = 0; i < count and not failed; ++i)
+    {
+        if(auto cached = take_cached(offset + (i * layer_size_bytes())))
+        {
+            m_cache_stats.hits += 1;
+
+            auto& s = slots.emplace_back(*std::move(cached));
+            wl_buffer_set_user_data(s.buffer.handle(), std::addressof(s.state));
+
+            continue;
+        }
+
+        m_cache_stats.misses += 1;
+
+        auto buffer = shm_buffer::make(parent,
+                                       {.index  = 0,
+                                        .offset = offset + (i * layer_size_bytes()),
+                                        .width  = m_info.width,
+                                        .height = m_info.height,
+                                        .format = m_info.format});
+
+        if(not buffer)
+        {
+            failed = true;
+            continue;
+        }
+
+        listen(slots.emplace_back(slot{.buffer = *std::move(buffer), .state = status::free, .pool = parent.id()}));
+    }
+
+    if(failed)
+    {
+        m_info = previous;
+        m_pool = previous_pool;
+
+        for(auto& s : slots)
+        {
+            cache(std::move(s));
+        }
+
+        // The previous layers come back in their order and with their state, ready and acquired ones included
+        for(auto* const h : handles)
+        {
+            const auto it = std::ranges::find(m_cache, h, [](const slot& s) noexcept { return s.buffer.handle(); });
+
+            auto& s = m_slots.emplace_back(std::move(*it));
+            m_cache.erase(it);
+
+            wl_buffer_set_user_data(s.buffer.handle(), std::addressof(s.state));
+        }
+
+        return any_call_info{};
+    }
+
+    m_slots.swap(slots);
+    m_ready.clear();
+    m_front.reset();
+
+    // Frames not presented yet are dropped, reused layers included
+    const auto reset = [](slot& s) noexcept
+    {
+        if(s.state != status::busy)
+        {
+            s.state = status::free;
+        }
+    };
+
+    std::ranges::for_each(m_slots, reset);
+    std::ranges::for_each(m_cache, reset);
+
+    trim();
+
+    return {};
+}
+
+[[nodiscard]]
+auto swapchain::take_cached(std::size_t offset) noexcept -> std::optional<slot>
+{
+    const auto it = std::ranges::find_if(m_cache,
+                                         [&](const slot& s) noexcept
+                                         {
+                                             const auto& b = s.buffer;
+
+                                             // The stride follows from the width and the format
+                                             return s.pool == m_pool and b.offset_bytes() == offset and b.width() == m_info.width
+                                                    and b.height() == m_info.height and b.format() == m_info.format;
+                                         });
+
+    if(it == m_cache.end())
+    {
+        return std::nullopt;
+    }
+
+    auto result = std::move(*it);
+    m_cache.erase(it);
+
+    return result;
+}
+
+[[nodiscard]]
+bool swapchain::in_current_region(const slot& s) const noexcept
+{
+    if(s.pool != m_pool)
+    {
+        return false;
+    }
+
+    const auto offset = s.buffer.offset_bytes();
+
+    return not m_block or (offset >= m_block->offset() and offset < m_block->offset() + m_block->size_bytes());
+}
+
+[[nodiscard]]
+bool swapchain::overlaps_busy(const slot& s) const noexcept
+{
+    const auto begin = s.buffer.offset_bytes();
+    const auto end   = begin + s.buffer.size_bytes();
+
+    return std::ranges::any_of(m_cache,
+                               [&](const slot& cached) noexcept
+                               {
+                                   const auto cached_begin = cached.buffer.offset_bytes();
+                                   const auto cached_end   = cached_begin + cached.buffer.size_bytes();
+
+                                   return cached.state == status::busy and cached.pool == s.pool and cached_begin < end
+                                          and begin < cached_end;
+                               });
+}
+
+void swapchain::trim() noexcept
+{
+    // Buffers outside of the current region can never be hit again, they are only kept until the compositor releases them
+    m_cache_stats.evictions
+        += std::erase_if(m_cache, [this](const slot& s) noexcept { return s.state != status::busy and not in_current_region(s); });
+
+    // Destroying a buffer the compositor still reads from would leave its contents undefined: the capacity is exceeded until release
+    for(auto it = m_cache.end(); m_cache.size() > cache_capacity and it != m_cache.begin();)
+    {
+        if((--it)->state != status::busy)
+        {
+            m_cache_stats.evictions += 1;
+            it = m_cache.erase(it);
+        }
+    }
+
+    std::erase_if(m_retired,
+                  [this](const shm_arena::block& b) noexcept
+                  {
+                      return std::ranges::none_of(m_cache,
+                                                  [&](const slot& s) noexcept
+                                                  {
+                                                      const auto offset = s.buffer.offset_bytes();
+                                                      return s.pool == b.pool().id() and offset >= b.offset()
+                                                             and offset < b.offset() + b.size_bytes();
+                                                  });
+                  });
+}
+
+[[nodiscard]]
+auto swapchain::acquire() noexcept -> std::optional<std::size_t>
+{
+    // Cached buffers are released on their own, this gives back the memory they were the last ones to use
+    if(not m_retired.empty() or m_cache.size() > cache_capacity)
+    {
+        trim();
+    }
+
+    const auto it = std::ranges::find_if(m_slots, [this](const slot& s) noexcept { return s.state == status::free and not overlaps_busy(s); });
+
+    if(it == m_slots.end())
+    {
+        return std::nullopt;
+    }
+
+    it->state = status::acquired;
+
+    return static_cast<std::size_t>(std::ranges::distance(m_slots.begin(), it));
+}
+
+void swapchain::submit(std::size_t index) noexcept
+{
+    if(m_info.presentation == mode::mailbox)
+    {
+        for(const auto stale : m_ready)
+        {
+            m_slots[stale].state = status::free;
+        }
+
+        m_ready.clear();
+    }
+
+    m_slots[index].state = status::ready;
+    m_ready.push_back(index);
+}
+
+bool swapchain::present(wl_surface* surface) noexcept
+{
+    if(m_ready.empty())
+    {
+        return false;
+    }
+
+    const auto index = m_ready.front();
+    m_ready.erase(m_ready.begin());
+
+    auto& s = m_slots[index];
+    s.state = status::busy;
+    m_front = index;
+
+    protocol_stats::send<WL_SURFACE_ATTACH>(wl_surface_attach, surface, s.buffer.handle(), 0, 0);
+
+    return true;
+}
+
+[[nodiscard]]
+auto swapchain::resize(shm_pool& parent, std::size_t width, std::size_t height) noexcept -> std::optional<any_call_info>
+{
+    auto next   = m_info;
+    next.width  = std::max(std::size_t{1}, width);
+    next.height = std::max(std::size_t{1}, height);
+
+    // Pools do not grow: layers past their end would be a protocol error
+    if(layer_size_bytes(next) * m_slots.size() > parent.size_bytes())
+    {
+        return any_call_info{};
+    }
+
+    return rebuild(parent, 0, next);
+}
+
+[[nodiscard]]
+auto swapchain::resize(std::size_t width, std::size_t height) noexcept -> std::optional<any_call_info>
+{
+    auto next   = m_info;
+    next.width  = std::max(std::size_t{1}, width);
+    next.height = std::max(std::size_t{1}, height);
+
+    return reallocate(next);
+}
+
+[[nodiscard]]
+auto swapchain::reallocate(const information& next) noexcept -> std::optional<any_call_info>
+{
+    if(not m_block)
+    {
+        return any_call_info{};
+    }
+
+    const auto required = layer_size_bytes(next) * m_slots.size();
+
+    if(required <= m_block->size_bytes())
+    {
+        return rebuild(m_block->pool(), m_block->offset(), next);
+    }
+
+    // Leave some headroom so that interactive resizes do not reallocate at each step
+    auto* const arena  = m_block->arena();
+    auto        region = arena->allocate(std::max(required, m_block->size_bytes() + m_block->size_bytes() / 2));
+
+    if(not region)
+    {
+        return any_call_info{};
+    }
+
+    m_prefault.stop();
+
+    auto previous = *std::exchange(m_block, *std::move(region));
+
+    if(const auto error = rebuild(m_block->pool(), m_block->offset(), next))
+    {
+        // The buffers created in the new region are evicted before the region goes back to the arena
+        const auto abandoned = *std::exchange(m_block, std::move(previous));
+        trim();
+        prefault();
+
+        return error;
+    }
+
+    // The buffers of the previous region moved to the cache, which gives the region back to the arena once they are all gone
+    m_retired.push_back(std::move(previous));
+
+    prefault();
+
+    return {};
+}
+
+[[nodiscard]]
+auto swapchain::reformat(wl_shm_format format) noexcept -> std::optional<any_call_info>
+{
+    if(not bytes_per_pixel(format))
+    {
+        return any_call_info{};
+    }
+
+    auto next   = m_info;
+    next.format = format;
+
+    return reallocate(next);
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
@@ -0,0 +1,353 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SWAPCHAIN_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SWAPCHAIN_HPP
+
+#include "prefault_worker.hpp"
+#include "shm_arena.hpp"
+#include "shm_buffer.hpp"
+#include "shm_pool.hpp"
+
+#include <cstddef>
+#include <expected>
+#include <list>
+#include <optional>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <wayland-client.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * A set of shm_buffer sharing the layers of a shm_pool, or of a region of a shm_arena.
+ * Each frame is drawn into a layer the compositor does not read anymore, which is tracked through wl_buffer.release.
+ * None of the functions of this class block: when every layer is still held by the compositor, acquire() fails and the frame should be
+ * skipped.
+ * Buffers replaced by a resize are kept in a small LRU cache, and reused when the same size and format come back. Buffers still held by
+ * the compositor are never evicted, and keep the memory they live in allocated until they are released.
+ * This class is not thread-safe: it must be used on the thread dispatching the events of the display.
+ */
+class swapchain
+{
+    struct token
+    {
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    /// Presentation modes.
+    enum class mode
+    {
+        double_buffering, ///< Two layers. Frames are presented in submission order.
+        triple_buffering, ///< Three layers. Frames are presented in submission order.
+        mailbox,          ///< Three layers. Only the most recently submitted frame is presented, older pending frames are recycled.
+    };
+
+    /// State of a layer.
+    enum class status
+    {
+        free,     ///< The layer can be acquired.
+        acquired, ///< The layer is being drawn into.
+        ready,    ///< The layer contains a complete frame that has not been attached yet.
+        busy,     ///< The layer was attached to a surface and the compositor has not released it yet.
+    };
+
+    struct information
+    {
+        std::size_t     width        = 1;
+        std::size_t     height       = 1;
+        swapchain::mode presentation = mode::double_buffering;
+
+        /// Format of the layers. Must be supported by the display, see display::supports.
+        wl_shm_format format = WL_SHM_FORMAT_ARGB8888;
+
+        /// Faults the pages of the layers in on a worker thread when they are allocated, so that the first frames do not stall on page
+        /// faults. Only applies to swapchains created from a shm_arena, whose pools never move.
+        bool background_prefault = false;
+
+        /// Queue the release events of the layers are dispatched on. Uses the queue of the pool if null.
+        wl_event_queue* queue = nullptr;
+    };
+
+    /// Counters of the buffer cache.
+    struct cache_statistics
+    {
+        std::size_t hits      = 0; ///< Layers that reused a cached wl_buffer.
+        std::size_t misses    = 0; ///< Layers that required a new wl_buffer.
+        std::size_t evictions = 0; ///< Cached wl_buffer destroyed to make room, or because the layers moved to another region.
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const cache_statistics& s)
+        {
+            return out << "buffer cache:{hits: " << s.hits << ", misses: " << s.misses << ", evictions: " << s.evictions << "}";
+        }
+    };
+
+    /// Maximum number of wl_buffer kept alive besides the layers.
+    static constexpr std::size_t cache_capacity = 8;
+
+    /// Returns the number of pool layers required by a presentation mode.
+    [[nodiscard]] static constexpr std::size_t layer_count(mode m) noexcept
+    {
+        constexpr std::size_t double_buffered = 2;
+        constexpr std::size_t triple_buffered = 3;
+
+        return (m == mode::double_buffering) ? double_buffered : triple_buffered;
+    }
+
+    swapchain(shm_pool& parent, information i) : swapchain{token{}, i}
+    {
+        if(const auto error = create(parent))
+        {
+            throw std::runtime_error("");
+        }
+    }
+
+    swapchain(shm_arena& parent, information i) : swapchain{token{}, i}
+    {
+        if(const auto error = create(parent))
+        {
+            throw std::runtime_error("");
+        }
+    }
+
+    swapchain(const swapchain&)            = delete;
+    swapchain& operator=(const swapchain&) = delete;
+
+    // Moving the vectors keeps their storage, so the slot addresses given to the wl_buffer listeners stay valid
+    swapchain(swapchain&& other) noexcept
+        : m_info{std::exchange(other.m_info, information{})},
+          m_block{std::exchange(other.m_block, std::nullopt)},
+          m_retired{std::move(other.m_retired)},
+          m_prefault{std::move(other.m_prefault)},
+          m_slots{std::move(other.m_slots)},
+          m_ready{std::move(other.m_ready)},
+          m_front{std::exchange(other.m_front, std::nullopt)},
+          m_cache{std::move(other.m_cache)},
+          m_pool{std::exchange(other.m_pool, 0)},
+          m_cache_stats{std::exchange(other.m_cache_stats, cache_statistics{})}
+    {
+    }
+
+    swapchain& operator=(swapchain&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~swapchain() noexcept = default;
+
+    [[nodiscard]] static std::expected<swapchain, any_call_info> make(shm_pool& parent, information i) noexcept
+    {
+        swapchain result{token{}, i};
+
+        if(const auto error = result.create(parent))
+        {
+            return std::unexpected{*error};
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] static std::expected<swapchain, any_call_info> make(shm_arena& parent, information i) noexcept
+    {
+        swapchain result{token{}, i};
+
+        if(const auto error = result.create(parent))
+        {
+            return std::unexpected{*error};
+        }
+
+        return result;
+    }
+
+    /**
+     * Returns the index of a free layer and marks it as acquired.
+     * Layers overlapping the memory of a cached buffer still held by the compositor are not free until that buffer is released.
+     * @returns The index of the layer, or std::nullopt if every layer is currently in use.
+     */
+    [[nodiscard]] std::optional<std::size_t> acquire() noexcept;
+
+    /**
+     * Marks an acquired layer as containing a complete frame.
+     * In mailbox mode, frames submitted before and not attached yet are recycled.
+     * @pre The layer must have been acquired.
+     */
+    void submit(std::size_t index) noexcept;
+
+    /**
+     * Attaches the next frame to a surface. The caller is responsible for committing the surface.
+     * @returns True if a frame was attached, false if no frame was ready.
+     */
+    bool present(wl_surface* surface) noexcept;
+
+    /**
+     * Recreates the buffers of each layer with a new size.
+     * Layers still held by the compositor are moved to the cache like the others, and stay there until they are released.
+     * On failure, the swapchain is left unchanged: its size, its layers and their state. Fails if the parent pool cannot hold
+     * layer_count(info().presentation) layers of the new size, for example.
+     */
+    [[nodiscard]] std::optional<any_call_info> resize(shm_pool& parent, std::size_t width, std::size_t height) noexcept;
+
+    /**
+     * Same as resize(shm_pool&, std::size_t, std::size_t), for swapchains created from a shm_arena.
+     * The current region is kept if it is large enough. Otherwise, a larger region is allocated, with some headroom for subsequent
+     * resizes.
+     */
+    [[nodiscard]] std::optional<any_call_info> resize(std::size_t width, std::size_t height) noexcept;
+
+    /**
+     * Recreates the buffer of each layer with a new format, for swapchains created from a shm_arena.
+     * Regions are handled as in resize(std::size_t, std::size_t).
+     * @pre The format must be supported by the display.
+     */
+    [[nodiscard]] std::optional<any_call_info> reformat(wl_shm_format format) noexcept;
+
+    [[nodiscard]] const auto& info() const noexcept { return m_info; }
+
+    [[nodiscard]] auto width() const noexcept { return m_info.width; }
+    [[nodiscard]] auto height() const noexcept { return m_info.height; }
+    [[nodiscard]] auto format() const noexcept { return m_info.format; }
+    [[nodiscard]] auto size() const noexcept { return m_slots.size(); }
+
+    [[nodiscard]] shm_buffer&       operator[](std::size_t index) noexcept { return m_slots[index].buffer; }
+    [[nodiscard]] const shm_buffer& operator[](std::size_t index) const noexcept { return m_slots[index].buffer; }
+
+    [[nodiscard]] status state(std::size_t index) const noexcept
+    {
+        const auto& s = m_slots[index];
+        return (s.state == status::free and overlaps_busy(s)) ? status::busy : s.state;
+    }
+
+    /// Returns the index of the layer last attached to a surface, if any.
+    [[nodiscard]] auto front() const noexcept { return m_front; }
+
+    [[nodiscard]] const auto& cache_stats() const noexcept { return m_cache_stats; }
+
+    void swap(swapchain& other) noexcept
+    {
+        std::swap(m_info, other.m_info);
+        m_block.swap(other.m_block);
+        m_retired.swap(other.m_retired);
+        m_prefault.swap(other.m_prefault);
+        m_slots.swap(other.m_slots);
+        m_ready.swap(other.m_ready);
+        std::swap(m_front, other.m_front);
+        m_cache.swap(other.m_cache);
+        std::swap(m_pool, other.m_pool);
+        std::swap(m_cache_stats, other.m_cache_stats);
+    }
+
+    friend void swap(swapchain& a, swapchain& b) noexcept { a.swap(b); }
+
+private:
+
+    struct slot
+    {
+        shm_buffer  buffer;
+        status      state = status::free;
+        std::size_t pool  = 0; ///< Identifier of the pool of the buffer, see shm_pool::id.
+    };
+
+    swapchain(token, information i) noexcept : m_info{i}
+    {
+        m_info.width  = std::max(std::size_t{1}, m_info.width);
+        m_info.height = std::max(std::size_t{1}, m_info.height);
+    }
+
+    /// Size of a layer, in bytes. Zero if the format is not supported.
+    [[nodiscard]] static std::size_t layer_size_bytes(const information& i) noexcept
+    {
+        return i.width * i.height * bytes_per_pixel(i.format).value_or(0);
+    }
+
+    [[nodiscard]] std::size_t layer_size_bytes() const noexcept { return layer_size_bytes(m_info); }
+
+    [[nodiscard]]
+    std::optional<any_call_info> create(shm_pool& parent, std::size_t offset = 0) noexcept;
+
+    [[nodiscard]]
+    std::optional<any_call_info> create(shm_arena& parent) noexcept;
+
+    /// Starts faulting the pages of the current region in, if requested by the information.
+    void prefault() noexcept;
+
+    /// Registers the release listener of a new layer, and moves it to the queue of the information.
+    void listen(slot& s) noexcept;
+
+    /// Moves a buffer to the front of the cache, and points its release listener to its new state.
+    void cache(slot&& s) noexcept;
+
+    /**
+     * Recreates the buffer of each layer with new information, starting at a given offset in a pool. Current buffers are moved to the
+     * cache. On failure, the layers, their state and the information are left as they were.
+     */
+    [[nodiscard]]
+    std::optional<any_call_info> rebuild(shm_pool& parent, std::size_t offset, const information& next) noexcept;
+
+    /// Rebuilds the layers of a swapchain created from a shm_arena with new information, in a larger region if needed.
+    [[nodiscard]]
+    std::optional<any_call_info> reallocate(const information& next) noexcept;
+
+    /// Takes the cached buffer matching a layer out of the cache, if any.
+    [[nodiscard]] std::optional<slot> take_cached(std::size_t offset) noexcept;
+
+    /// Returns true if a buffer lives in the memory currently holding the layers, the only memory where cached buffers can be reused.
+    [[nodiscard]] bool in_current_region(const slot& s) const noexcept;
+
+    /// Returns true if the memory of a layer overlaps a cached buffer the compositor has not released yet.
+    [[nodiscard]] bool overlaps_busy(const slot& s) const noexcept;
+
+    /// Evicts the cached buffers that cannot be reused or exceed the capacity, and gives back the regions none of them lives in anymore.
+    void trim() noexcept;
+
+    information                     m_info     = {};
+    std::optional<shm_arena::block> m_block    = {}; ///< Region holding the layers, when created from an arena. Outlives the buffers.
+    std::vector<shm_arena::block>   m_retired  = {}; ///< Previous regions, released once no cached buffer lives in them anymore.
+    prefault_worker                 m_prefault = {}; ///< Touches the pages of m_block. Stopped before m_block is released.
+    std::vector<slot>               m_slots    = {};
+    std::vector<std::size_t>        m_ready    = {}; ///< Layers in the ready state, in submission order.
+    std::optional<std::size_t>      m_front    = {};
+
+    // Nodes of a list do not move, so the wl_buffer listeners of cached buffers can point to them
+    std::list<slot>  m_cache       = {}; ///< Most recently used first.
+    std::size_t      m_pool        = 0;  ///< Identifier of the pool holding the layers, see shm_pool::id.
+    cache_statistics m_cache_stats = {};
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_SWAPCHAIN_HPP
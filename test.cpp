@@ -26,16 +26,27 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "canvas.hpp"
 #include "display.hpp"
+#include "event_loop.hpp"
+#include "protocol_stats.hpp"
 #include "screen.hpp"
+#include "shm_arena.hpp"
 #include "shm_buffer.hpp"
 #include "shm_pool.hpp"
+#include "task.hpp"
 #include "test.hpp"
 #include "window.hpp"
 
+#if defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+    #include "mock/compositor.hpp"
+#endif
+
+#include <array>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
-#include <thread>
+#include <vector>
 
 namespace sandbox::wayland
 {
@@ -112,6 +123,76 @@ namespace sandbox::wayland
         return 3;
     }
 
+    fbk_wl::canvas canvas{*buffer};
+
+    std::ignore = canvas.clear(0xFF000000);
+    std::ignore = canvas.blend_rect({.offset = {-16, -16}, .extent = {32, 32}}, 0x80800000);
+
+    // Half red over opaque black, both premultiplied. The rectangle is clipped to the top-left corner
+    if(const auto pixel = view(*buffer).memory.subspan(15 * canvas.stride() + 15 * 4, 4);
+       std::to_integer<int>(pixel[2]) != 0x80 or std::to_integer<int>(pixel[3]) != 0xFF)
+    {
+        return 5;
+    }
+
+    std::cout << "shm formats:" << std::hex;
+    for(const auto f : display->formats())
+    {
+        std::cout << " 0x" << f;
+    }
+    std::cout << std::dec << "\n";
+
+    // Half the size of an ARGB8888 image, fits in the second layer of the pool
+    if(display->supports(WL_SHM_FORMAT_RGB565))
+    {
+        auto rgb565 = fbk_wl::shm_buffer::make(*pool, fbk_wl::shm_buffer::information{.index = 1, .format = WL_SHM_FORMAT_RGB565});
+
+        if(not rgb565 or rgb565->stride() != 512 * 2)
+        {
+            return 4;
+        }
+    }
+
+    // Past the two layers of the pool
+    if(fbk_wl::shm_buffer::make(*pool, fbk_wl::shm_buffer::information{.index = 2}))
+    {
+        return 6;
+    }
+
+    return 0;
+}
+
+[[nodiscard]] int shm_arena()
+{
+    auto display = fbk_wl::display::make();
+
+    if(not display)
+    {
+        return 1;
+    }
+
+    constexpr std::size_t window_bytes = std::size_t{640} * 480 * 4 * 2;
+
+    auto a = display->arena().allocate(window_bytes);
+    auto b = display->arena().allocate(window_bytes);
+    auto c = display->arena().allocate(window_bytes);
+
+    if(not a or not b or not c)
+    {
+        return 2;
+    }
+
+    if(std::addressof(a->pool()) != std::addressof(c->pool()))
+    {
+        return 3; // Small regions are expected to share a pool
+    }
+
+    {
+        const auto released = *std::move(b); // Leaves a hole between a and c
+    }
+
+    std::cout << display->arena().stats() << "\n" << std::flush;
+
     return 0;
 }
 
@@ -124,6 +205,14 @@ namespace sandbox::wayland
         return 1;
     }
 
+    // Screens plugged, unplugged or reconfigured while the window is open
+    display->outputs().on_change(
+        [](fbk_wl::output_list::change c, const fubuki::io::platform::screen_properties& p)
+        {
+            constexpr std::array<const char*, 3> names = {"added", "changed", "removed"};
+            std::cout << names.at(static_cast<std::size_t>(c)) << " " << p << "\n" << std::flush;
+        });
+
     auto window = fbk_wl::window::make(*display,
                                        fubuki::io::platform::window_info{
                                            .title       = "Wayland window",
@@ -138,40 +227,327 @@ namespace sandbox::wayland
         return 2;
     }
 
+    constexpr std::int32_t square = 64;
+
+    // Horizontal offset of the checkerboard, advanced once per frame
+    std::int32_t scroll = 0;
+
+    // A checkerboard in window coordinates, drawn by the tile renderer. Each tile only draws the squares it overlaps
+    window->set_draw(
+        [&scroll](fbk_wl::canvas& tile, fubuki::rectangle2d area)
+        {
+            constexpr std::uint32_t grey = 0xFF808080;
+
+            const std::int32_t first = (area.offset.x + scroll) / square * square - scroll;
+
+            for(std::int32_t y = area.offset.y / square * square; y < area.offset.y + area.extent.height; y += square)
+            {
+                for(std::int32_t x = first; x < area.offset.x + area.extent.width; x += square)
+                {
+                    if(((x + scroll) / square + y / square) % 2 == 0)
+                    {
+                        std::ignore = tile.fill_rect({.offset = {x - area.offset.x, y - area.offset.y}, .extent = {square, square}}, grey);
+                    }
+                }
+            }
+        });
+
+    // One square every 512 ms, at the refresh rate of the output. Stops while the window is hidden
+    window->animate([&scroll](std::uint32_t time) { scroll = static_cast<std::int32_t>(time / 8 % (square * 2)); });
+
     // window->show();
 
+    auto loop = fbk_wl::event_loop::make(*display);
+
+    if(not loop)
+    {
+        return 3;
+    }
+
     bool s = true;
 
-    while (wl_display_dispatch(display->handle())) {
-        std::this_thread::sleep_for(std::chrono::seconds{1});
+    const auto toggle = loop->add_timer(std::chrono::seconds{1},
+                                        std::chrono::seconds{1},
+                                        [&]
+                                        {
+                                            {
+                                                // Both changes reach the compositor with a single commit and a single redraw
+                                                const fbk_wl::window::transaction t{*window};
+
+                                                if(s)
+                                                {
+                                                    // window->move({512, 512});
+                                                    window->resize({480, 640});
+                                                    window->set_opacity(0.1f);
+                                                }
+                                                else
+                                                {
+                                                    // window->move({0, 0});
+                                                    window->resize({640, 480});
+                                                    window->set_opacity(1.f);
+                                                }
+                                            }
+
+                                            s = not s;
+
+                                            std::cout << window->chain().cache_stats() << "\n"
+                                                      << window->presented().stats() << "\n"
+                                                      << window->transaction_stats() << "\n"
+                                                      << window->frame_stats() << "\n"
+                                                      << fbk_wl::protocol_stats::snapshot() << "\n"
+                                                      << std::flush;
+                                        });
+
+    if(not toggle)
+    {
+        return 4;
+    }
+
+    if(const auto error = loop->run())
+    {
+        return 5;
+    }
+
+    // for(int i = 0; i < 3; ++i)
+    // {
+    //     wl_display_dispatch_pending(display->handle());
+    //     std::this_thread::sleep_for(std::chrono::seconds{1});
+    // }
+
+    return 0;
+}
+
+[[nodiscard]] int async_windows()
+{
+    auto display = fbk_wl::display::make();
+
+    if(not display)
+    {
+        return 1;
+    }
+
+    auto loop = fbk_wl::event_loop::make(*display);
 
-        if(s)
+    if(not loop)
+    {
+        return 2;
+    }
+
+    constexpr std::size_t count = 3;
+
+    std::vector<fbk_wl::window> windows;
+    windows.reserve(count);
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        // Returns without waiting for the compositor
+        auto window = fbk_wl::window::make(*display,
+                                           fubuki::io::platform::window_info{.title = "Async window " + std::to_string(i), .size = {320, 240}},
+                                           fbk_wl::swapchain::mode::double_buffering,
+                                           fbk_wl::window::queue_policy::shared,
+                                           fbk_wl::window::configure_policy::defer);
+
+        if(not window)
         {
-            // window->move({512, 512});
-            window->resize({480, 640});
-            window->set_opacity(0.1f);
+            return 3;
         }
-        else
+
+        windows.push_back(*std::move(window));
+    }
+
+    using clock = std::chrono::steady_clock;
+    using ms    = std::chrono::duration<double, std::milli>;
+
+    const auto  start   = clock::now();
+    std::size_t running = count;
+
+    // One coroutine per window: the windows wait for their configure event and their frames at the same time, on this thread
+    const auto show = [&](fbk_wl::window& w, std::size_t index) -> fbk_wl::task
+    {
+        co_await w.configured();
+        const auto configured = clock::now();
+
+        const auto first  = co_await w.next_frame();
+        const auto second = co_await w.next_frame();
+
+        std::cout << "window " << index << ": configured after " << ms{configured - start}.count() << " ms, frame interval "
+                  << (second - first) << " ms\n"
+                  << std::flush;
+
+        if(--running == 0)
         {
-            // window->move({0, 0});
-            window->resize({640, 480});
-            window->set_opacity(1.f);
+            loop->stop();
         }
+    };
 
-        s = not s;
+    const auto startup = [&]() -> fbk_wl::task
+    {
+        // Every window was created when the compositor answers
+        co_await display->sync();
+        std::cout << "sync after " << ms{clock::now() - start}.count() << " ms\n" << std::flush;
+
+        for(std::size_t i = 0; i < windows.size(); ++i)
+        {
+            show(windows[i], i);
+        }
+    };
 
+    startup();
 
-        /* This space deliberately left blank */
+    if(const auto error = loop->run())
+    {
+        return 4;
     }
 
+    std::cout << fbk_wl::protocol_stats::snapshot() << "\n" << std::flush;
 
-    // for(int i = 0; i < 3; ++i)
-    // {
-    //     wl_display_dispatch_pending(display->handle());
-    //     std::this_thread::sleep_for(std::chrono::seconds{1});
-    // }
+    return 0;
+}
+
+#if defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
+[[nodiscard]] int mock_compositor()
+{
+    // The second size is sent once the window acknowledged the first one
+    auto compositor = fbk_wl::mock::compositor::make({.configures = {{0, 0}, {800, 600}}});
+
+    if(not compositor)
+    {
+        return 1;
+    }
+
+    auto display = fbk_wl::display::make(compositor->socket_name());
+
+    if(not display)
+    {
+        return 2;
+    }
+
+    display->outputs().on_change(
+        [](fbk_wl::output_list::change c, const fubuki::io::platform::screen_properties& p)
+        {
+            constexpr std::array<const char*, 3> names = {"added", "changed", "removed"};
+            std::cout << names.at(static_cast<std::size_t>(c)) << " " << p << "\n" << std::flush;
+        });
+
+    auto window = fbk_wl::window::make(*display, fubuki::io::platform::window_info{.title = "Mock window", .size = {640, 480}});
+
+    if(not window)
+    {
+        return 3;
+    }
+
+    auto loop = fbk_wl::event_loop::make(*display);
+
+    if(not loop)
+    {
+        return 4;
+    }
+
+    // A zero size keeps the one of the window, any other size resizes the swapchain
+    const auto sized = [&](std::size_t width, std::size_t height)
+    { return window->chain().width() == width and window->chain().height() == height; };
+
+    bool kept = false;
+
+    const auto frames = [&]() -> fbk_wl::task
+    {
+        co_await window->configured();
+        kept = sized(640, 480);
+
+        for(int i = 0; i < 3; ++i)
+        {
+            std::cout << "frame at " << co_await window->next_frame() << " ms\n" << std::flush;
+        }
+
+        // Plugged while the window is open, like a hotplug
+        compositor->add_output({.name = "MOCK-2", .position = {1920, 0}});
+        compositor->set_latency(std::chrono::milliseconds{5});
+
+        co_await display->sync();
+        co_await window->next_frame();
+
+        loop->stop();
+    };
+
+    frames();
+
+    if(const auto error = loop->run())
+    {
+        return 5;
+    }
+
+    if(not kept or not sized(800, 600))
+    {
+        return 6;
+    }
+
+    std::cout << compositor->stats() << "\n" << fbk_wl::protocol_stats::snapshot() << "\n" << std::flush;
 
     return 0;
 }
 
+[[nodiscard]] int mock_windows()
+{
+    auto compositor = fbk_wl::mock::compositor::make();
+
+    if(not compositor)
+    {
+        return 1;
+    }
+
+    auto display = fbk_wl::display::make(compositor->socket_name());
+
+    if(not display)
+    {
+        return 2;
+    }
+
+    constexpr std::size_t rounds = 3;
+    constexpr std::size_t count  = 4;
+
+    // Windows on the shared queue create their surfaces from the xdg_wm_base of the display: destroying one must leave it to the others
+    for(std::size_t round = 0; round < rounds; ++round)
+    {
+        std::vector<fbk_wl::window> windows;
+        windows.reserve(count);
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            auto window = fbk_wl::window::make(*display,
+                                               fubuki::io::platform::window_info{.title = "Mock window " + std::to_string(i), .size = {320, 240}});
+
+            if(not window)
+            {
+                return 3;
+            }
+
+            windows.push_back(*std::move(window));
+
+            // Destroyed while the others are open
+            if(i == 1)
+            {
+                windows.erase(windows.begin());
+            }
+        }
+
+        if(display->roundtrip() < 0)
+        {
+            return 4;
+        }
+    }
+
+    // Every window is gone: the display still uses the global
+    if(display->roundtrip() < 0)
+    {
+        return 5;
+    }
+
+    std::cout << compositor->stats() << "\n" << std::flush;
+
+    return 0;
+}
+
+#endif // defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
 } // namespace sandbox::wayland
@@ -44,8 +44,20 @@ namespace fbk_wl = fubuki::io::platform::linux_bsd::wayland;
 
 [[nodiscard]] int shm_buffer();
 
+[[nodiscard]] int shm_arena();
+
 [[nodiscard]] int window();
 
+[[nodiscard]] int async_windows();
+
+#if defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
+[[nodiscard]] int mock_compositor();
+
+[[nodiscard]] int mock_windows();
+
+#endif // defined(FUBUKI_HAS_MOCK_COMPOSITOR)
+
 } // namespace sandbox::wayland
 
 #endif // WAYLAND_SANDBOX_TEST_HPP
@@ -0,0 +1,266 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "tile_renderer.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+namespace
+{
+
+constexpr std::size_t pixel_size = 4;
+
+/// Width of the default tiles: rows of 1 KiB keep the hardware prefetcher streaming.
+constexpr std::int32_t default_tile_width = 256;
+
+constexpr std::int32_t min_tile_height = 16;
+
+[[nodiscard]] std::size_t detect_l2_cache() noexcept
+{
+    constexpr long fallback = 1L << 20U;
+
+    const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+
+    return static_cast<std::size_t>(size > 0 ? size : fallback);
+}
+
+[[nodiscard]] constexpr std::uint64_t pack(std::uint32_t first, std::uint32_t last) noexcept
+{
+    return (std::uint64_t{last} << 32U) | first;
+}
+
+[[nodiscard]] constexpr std::uint32_t first_of(std::uint64_t range) noexcept { return static_cast<std::uint32_t>(range); }
+[[nodiscard]] constexpr std::uint32_t last_of(std::uint64_t range) noexcept { return static_cast<std::uint32_t>(range >> 32U); }
+
+/// Takes the first tile of the range of the calling thread.
+[[nodiscard]] std::optional<std::uint32_t> pop(std::atomic<std::uint64_t>& queue) noexcept
+{
+    auto range = queue.load(std::memory_order_relaxed);
+
+    while(first_of(range) < last_of(range))
+    {
+        if(queue.compare_exchange_weak(range, pack(first_of(range) + 1, last_of(range)), std::memory_order_relaxed))
+        {
+            return first_of(range);
+        }
+    }
+
+    return std::nullopt;
+}
+
+/// Takes the last tile of the range of another thread, away from the tiles its owner is about to draw.
+[[nodiscard]] std::optional<std::uint32_t> steal(std::atomic<std::uint64_t>& queue) noexcept
+{
+    auto range = queue.load(std::memory_order_relaxed);
+
+    while(first_of(range) < last_of(range))
+    {
+        if(queue.compare_exchange_weak(range, pack(first_of(range), last_of(range) - 1), std::memory_order_relaxed))
+        {
+            return last_of(range) - 1;
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+tile_renderer::tile_renderer(token, information i) noexcept : m_info{i}
+{
+    if(m_info.threads == 0)
+    {
+        m_info.threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    if(m_info.tile.width <= 0)
+    {
+        m_info.tile.width = default_tile_width;
+    }
+
+    // Half of L2, leaving room for whatever the callback reads
+    if(m_info.tile.height <= 0)
+    {
+        const auto rows = detect_l2_cache() / 2 / (static_cast<std::size_t>(m_info.tile.width) * pixel_size);
+
+        m_info.tile.height = std::max(min_tile_height, static_cast<std::int32_t>(std::min<std::size_t>(rows, 1U << 16U)));
+    }
+}
+
+[[nodiscard]] std::optional<tile_renderer::any_call_info> tile_renderer::create() noexcept
+{
+    try
+    {
+        m_state         = std::make_unique<state>();
+        m_state->queues = std::make_unique<std::atomic<std::uint64_t>[]>(m_info.threads);
+
+        m_workers.reserve(m_info.threads - 1);
+
+        for(std::size_t i = 0; i + 1 < m_info.threads; ++i)
+        {
+            m_workers.emplace_back(
+                [s = m_state.get(), i, participants = m_info.threads](std::stop_token stop)
+                {
+                    std::uint64_t seen = 0;
+
+                    for(;;)
+                    {
+                        {
+                            std::unique_lock lock{s->mutex};
+
+                            if(not s->wake.wait(lock, stop, [&] { return s->generation != seen; }))
+                            {
+                                return;
+                            }
+
+                            seen = s->generation;
+                        }
+
+                        run(*s, i, participants);
+
+                        {
+                            const std::scoped_lock lock{s->mutex};
+
+                            if(--s->busy == 0)
+                            {
+                                s->done.notify_one();
+                            }
+                        }
+                    }
+                });
+        }
+    }
+    catch(const std::system_error& e)
+    {
+        std::cerr << "Failed to start a tile renderer thread: " << e.what() << "\n" << std::flush;
+        return any_call_info{};
+    }
+    catch(const std::bad_alloc&)
+    {
+        return any_call_info{};
+    }
+
+    return {};
+}
+
+void tile_renderer::run(state& s, std::size_t self, std::size_t participants) noexcept
+{
+    const auto draw_tile = [&s](std::uint32_t index)
+    {
+        const auto& t = s.tile;
+
+        const std::int32_t x = static_cast<std::int32_t>(index % s.columns) * t.width;
+        const std::int32_t y = static_cast<std::int32_t>(index / s.columns) * t.height;
+
+        const rectangle2d area = {
+            .offset = {x, y},
+            .extent = {std::min(t.width, static_cast<std::int32_t>(s.target->width()) - x),
+                       std::min(t.height, static_cast<std::int32_t>(s.target->height()) - y)},
+        };
+
+        const auto offset = static_cast<std::size_t>(y) * s.target->stride() + static_cast<std::size_t>(x) * pixel_size;
+
+        canvas tile{s.target->memory().subspan(offset),
+                    static_cast<std::size_t>(area.extent.width),
+                    static_cast<std::size_t>(area.extent.height),
+                    s.target->stride()};
+
+        (*s.draw)(tile, area);
+    };
+
+    while(const auto index = pop(s.queues[self]))
+    {
+        draw_tile(*index);
+    }
+
+    for(std::size_t k = 1; k < participants; ++k)
+    {
+        while(const auto index = steal(s.queues[(self + k) % participants]))
+        {
+            draw_tile(*index);
+        }
+    }
+}
+
+void tile_renderer::render(canvas& target, const draw_callback& draw) noexcept
+{
+    const auto columns = (target.width() + static_cast<std::size_t>(m_info.tile.width) - 1) / static_cast<std::size_t>(m_info.tile.width);
+    const auto rows    = (target.height() + static_cast<std::size_t>(m_info.tile.height) - 1) / static_cast<std::size_t>(m_info.tile.height);
+    const auto tiles   = columns * rows;
+
+    if(tiles == 0)
+    {
+        return;
+    }
+
+    auto& s = *m_state;
+
+    s.target  = std::addressof(target);
+    s.draw    = std::addressof(draw);
+    s.tile    = m_info.tile;
+    s.columns = columns;
+
+    // Waking threads for a single tile costs more than it saves
+    if(m_workers.empty() or tiles == 1)
+    {
+        s.queues[0].store(pack(0, static_cast<std::uint32_t>(tiles)), std::memory_order_relaxed);
+        run(s, 0, 1);
+        return;
+    }
+
+    // Contiguous ranges, so that each thread walks its own band of rows
+    for(std::size_t p = 0; p < m_info.threads; ++p)
+    {
+        const auto first = static_cast<std::uint32_t>(tiles * p / m_info.threads);
+        const auto last  = static_cast<std::uint32_t>(tiles * (p + 1) / m_info.threads);
+
+        s.queues[p].store(pack(first, last), std::memory_order_relaxed);
+    }
+
+    {
+        const std::scoped_lock lock{s.mutex};
+        s.busy = m_workers.size();
+        ++s.generation;
+    }
+
+    s.wake.notify_all();
+
+    run(s, m_info.threads - 1, m_info.threads);
+
+    std::unique_lock lock{s.mutex};
+    s.done.wait(lock, [&s] { return s.busy == 0; });
+}
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
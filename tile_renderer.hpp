@@ -0,0 +1,189 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2025, Erwan DUHAMEL
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_TILE_RENDERER_HPP
+#define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_TILE_RENDERER_HPP
+
+#include "canvas.hpp"
+#include "shm_buffer.hpp"
+#include "types.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fubuki::io::platform::linux_bsd::wayland
+{
+
+/**
+ * Splits a canvas into tiles that fit in the L2 cache and draws them on a pool of threads.
+ * Each participant, the calling thread included, starts with a contiguous range of tiles and steals from the end of the others' ranges once
+ * its own is exhausted, so that uneven callbacks still keep every thread busy. render returns once every tile is drawn: the buffer can be
+ * submitted right after.
+ */
+class tile_renderer
+{
+    struct token
+    {
+    };
+
+public:
+
+    struct any_call_info
+    {
+    };
+
+    struct information
+    {
+        /// Number of threads drawing tiles, the calling thread included. 0 uses std::thread::hardware_concurrency.
+        std::size_t threads = 0;
+
+        /// Size of a tile, in pixels. Null dimensions are derived from the size of the L2 cache.
+        dimension2d tile = {};
+    };
+
+    /**
+     * Draws a tile. Called concurrently, from several threads, with distinct tiles.
+     * @param tile Canvas over the pixels of the tile. Its top-left pixel is at area.offset in the rendered canvas.
+     * @param area Rectangle of the rendered canvas covered by the tile.
+     */
+    using draw_callback = std::function<void(canvas& tile, rectangle2d area)>;
+
+    tile_renderer() : tile_renderer{information{}} {}
+
+    explicit tile_renderer(information i) : tile_renderer{token{}, i}
+    {
+        if(const auto error = create())
+        {
+            throw std::runtime_error("Failed to start the tile renderer threads");
+        }
+    }
+
+    tile_renderer(const tile_renderer&)            = delete;
+    tile_renderer& operator=(const tile_renderer&) = delete;
+
+    tile_renderer(tile_renderer&& other) noexcept
+        : m_info{std::exchange(other.m_info, information{})},
+          m_state{std::exchange(other.m_state, nullptr)},
+          m_workers{std::exchange(other.m_workers, {})}
+    {
+    }
+
+    tile_renderer& operator=(tile_renderer&& other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    /// Destructor. Stops and joins the threads.
+    ~tile_renderer() noexcept = default;
+
+    [[nodiscard]] static std::expected<tile_renderer, any_call_info> make(information i) noexcept
+    {
+        tile_renderer result = {token{}, i};
+
+        if(const auto error = result.create())
+        {
+            return std::unexpected{*error};
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] const auto& info() const noexcept { return m_info; }
+
+    /// Returns the number of threads drawing tiles, the calling thread included.
+    [[nodiscard]] auto threads() const noexcept { return m_info.threads; }
+
+    /**
+     * Draws every tile of a canvas and waits for all of them. Must not be called concurrently on the same renderer.
+     * @param draw Called once per tile. Must not throw.
+     */
+    void render(canvas& target, const draw_callback& draw) noexcept;
+
+    /// Same as render(canvas&, const draw_callback&), drawing to the pixels of a buffer.
+    void render(shm_buffer& target, const draw_callback& draw) noexcept
+    {
+        canvas c{target};
+        render(c, draw);
+    }
+
+    void swap(tile_renderer& other) noexcept
+    {
+        std::swap(m_info, other.m_info);
+        m_state.swap(other.m_state);
+        m_workers.swap(other.m_workers);
+    }
+
+    friend void swap(tile_renderer& a, tile_renderer& b) noexcept { a.swap(b); }
+
+private:
+
+    /// Work shared with the threads. Lives on the heap so that it does not move with the renderer.
+    struct state
+    {
+        std::mutex                  mutex      = {};
+        std::condition_variable_any wake       = {}; ///< Notified when a frame starts, or when the threads must stop.
+        std::condition_variable     done       = {}; ///< Notified when the last thread finishes its tiles.
+        std::uint64_t               generation = 0;  ///< Incremented for each frame.
+        std::size_t                 busy       = 0;  ///< Threads still drawing the current frame.
+
+        canvas*              target  = nullptr;
+        const draw_callback* draw    = nullptr;
+        dimension2d          tile    = {};
+        std::size_t          columns = 0;
+
+        /// Remaining tiles of each participant, as [first, last) packed in 32 bits each. The calling thread uses the last one.
+        std::unique_ptr<std::atomic<std::uint64_t>[]> queues = nullptr;
+    };
+
+    tile_renderer(token, information i) noexcept;
+
+    [[nodiscard]] std::optional<any_call_info> create() noexcept;
+
+    /// Draws tiles until every range is empty: first the range of participant self, then the others'.
+    static void run(state& s, std::size_t self, std::size_t participants) noexcept;
+
+    information               m_info    = {};
+    std::unique_ptr<state>    m_state   = nullptr; ///< Declared before m_workers, which must be joined first.
+    std::vector<std::jthread> m_workers = {};
+};
+
+} // namespace fubuki::io::platform::linux_bsd::wayland
+
+#endif // FUBUKI_IO_PLATFORM_LINUX_WAYLAND_TILE_RENDERER_HPP
@@ -26,10 +26,13 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "protocol_stats.hpp"
+#include "wp/generated/presentation-time-client-protocol.hpp"
 #include "window.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
-#include <ranges>
 
 namespace fubuki::io::platform::linux_bsd::wayland
 {
@@ -37,25 +40,159 @@ namespace fubuki::io::platform::linux_bsd::wayland
 namespace
 {
 
-void apply_opacity(window::components& c)
+/// Returns the background of a window: black, with the window opacity. Black is its own premultiplied colour.
+[[nodiscard]] std::uint32_t background(const shm_buffer& buffer, float opacity) noexcept
 {
     constexpr auto scale = 255.f;
 
-    std::ranges::fill(c.buffer.memory() | std::views::enumerate
-                          | std::views::filter(
-                              [](const auto& t) noexcept
-                              {
-                                  const auto& [index, byte] = t;
-                                  std::ignore               = byte;
-                                  return (index % 4 == 3); // The only format supported is A8R8G8B8, little-endian, thus this byte
-                              })
-                          | std::views::values,
-                      static_cast<std::byte>(c.info.opacity * scale));
+    // X channels are ignored by the compositor
+    const auto alpha = is_opaque(buffer.format()) ? std::uint32_t{0xFF} : static_cast<std::uint32_t>(opacity * scale);
+
+    return alpha << 24U;
+}
+
+/**
+ * Draws a new frame in a free layer of the swapchain and attaches it to the surface. Does not commit.
+ * Inside a transaction, only records that a frame is needed: window::apply draws it.
+ * @returns False if every layer is still held by the compositor, in which case the frame is skipped.
+ */
+bool redraw(window::components& c) noexcept
+{
+    if(c.batch.depth > 0)
+    {
+        ++c.batch.redraws;
+        return true;
+    }
+
+    const auto index = c.chain.acquire();
+
+    if(not index)
+    {
+        return false;
+    }
+
+    c.frame_times.begin_frame();
+
+    auto&      layer  = c.chain[*index];
+    const auto colour = background(layer, c.info.opacity);
+
+    // Clearing each tile right before drawing it keeps its pixels in cache for the callback
+    const auto draw_tile = [&c, colour](canvas& tile, rectangle2d area)
+    {
+        std::ignore = tile.clear(colour);
+
+        if(c.draw)
+        {
+            c.draw(tile, area);
+        }
+    };
+
+    // The renderer threads are only started by the first draw callback: a plain background is filled by the calling thread
+    if(c.renderer)
+    {
+        c.renderer->render(layer, draw_tile);
+    }
+    else
+    {
+        canvas whole{layer};
+        draw_tile(whole, whole.bounds());
+    }
+
+    c.chain.submit(*index);
+
+    if(not c.chain.present(c.surface.handle()))
+    {
+        return false;
+    }
+
+    // Every pixel of the layer was repainted, but only the areas marked by window::damage differ from the previous frame. Without any,
+    // nothing tells which pixels changed
+    if(c.dirty.empty())
+    {
+        c.dirty.add_all();
+    }
+
+    return true;
+}
+
+/// Posts the accumulated damage, requests presentation feedback and commits the surface. Inside a transaction, only records the request.
+void commit(window::components& c) noexcept
+{
+    if(c.batch.depth > 0)
+    {
+        ++c.batch.commits;
+        return;
+    }
+
+    c.dirty.flush(c.surface.handle());
+
+    if(c.presentation_time != nullptr)
+    {
+        c.presented.track(protocol_stats::send<WP_PRESENTATION_FEEDBACK>(wp_presentation_feedback, c.presentation_time, c.surface.handle()));
+    }
+
+    c.frame_times.commit();
+
+    protocol_stats::send<WL_SURFACE_COMMIT>(wl_surface_commit, c.surface.handle());
+}
+
+/// Sets the window geometry from the window information. Inside a transaction, sent once by window::apply.
+void set_geometry(window::components& c) noexcept
+{
+    if(c.batch.depth > 0)
+    {
+        c.batch.geometry = true;
+        return;
+    }
+
+    protocol_stats::send<XDG_SURFACE_SET_WINDOW_GEOMETRY>(
+        xdg_surface_set_window_geometry, c.surface.xdg_handle(), c.info.coordinates.x, c.info.coordinates.y, c.info.size.width, c.info.size.height);
 }
 
+void schedule_frame(window::components& c) noexcept;
+
 namespace callback
 {
 
+namespace frame
+{
+
+void done(void* data, wl_callback* callback, std::uint32_t time) noexcept
+{
+    auto* w = static_cast<window::components*>(data);
+
+    wl_callback_destroy(callback);
+    w->frame = nullptr;
+
+    // Taken now, so that the animation step may request the next frame
+    const auto once = std::exchange(w->on_frame, {});
+
+    if(w->animation)
+    {
+        // A copy, since the step may stop the animation
+        const auto step = w->animation;
+        step(time);
+
+        // Without a free layer, the frame is skipped but the next one is still requested: the loop must not stall
+        std::ignore = redraw(*w);
+
+        if(w->animation)
+        {
+            schedule_frame(*w);
+        }
+
+        commit(*w);
+    }
+
+    // Last: the window is not touched once the awaiting coroutine has resumed
+    if(once)
+    {
+        once(time);
+    }
+}
+
+} // namespace frame
+
 namespace seat
 {
 
@@ -116,16 +253,32 @@ namespace surface
 void configure(void* data, xdg_surface* xdg_surface, std::uint32_t serial)
 {
     auto* w = static_cast<window::components*>(data);
-    xdg_surface_ack_configure(xdg_surface, serial);
+    protocol_stats::send<XDG_SURFACE_ACK_CONFIGURE>(xdg_surface_ack_configure, xdg_surface, serial);
 
-    apply_opacity(*w);
-    wl_surface_attach(w->surface.handle(), w->buffer.handle(), 0, 0);
+    w->dirty.add_all();
+    std::ignore = redraw(*w);
 
-    xdg_surface_set_window_geometry(w->surface.xdg_handle(), w->info.coordinates.x, w->info.coordinates.y, w->info.size.width, w->info.size.height);
+    protocol_stats::send<XDG_SURFACE_SET_WINDOW_GEOMETRY>(xdg_surface_set_window_geometry,
+                                                          w->surface.xdg_handle(),
+                                                          w->info.coordinates.x,
+                                                          w->info.coordinates.y,
+                                                          w->info.size.width,
+                                                          w->info.size.height);
 
-    xdg_toplevel_set_title(w->toplevel.handle(), w->info.title.c_str());
+    protocol_stats::send<XDG_TOPLEVEL_SET_TITLE>(xdg_toplevel_set_title, w->toplevel.handle(), w->info.title.c_str());
+
+    commit(*w);
+
+    if(not w->configured)
+    {
+        w->configured = true;
 
-    wl_surface_commit(w->surface.handle());
+        // Last: the window is not touched once the awaiting coroutine has resumed
+        for(const auto h : std::exchange(w->configure_waiters, {}))
+        {
+            h.resume();
+        }
+    }
 }
 
 } // namespace surface
@@ -135,8 +288,22 @@ namespace toplevel
 
 void configure(void* data, xdg_toplevel* /*toplevel*/, std::int32_t width, std::int32_t height, wl_array* /*states*/) noexcept
 {
-    auto* w      = static_cast<window::components*>(data);
+    auto* w = static_cast<window::components*>(data);
+
+    // Zero leaves the size to the client: the current one is kept
+    if(width <= 0 or height <= 0 or dimension2d{width, height} == w->info.size)
+    {
+        return;
+    }
+
+    // The surface configure that follows redraws and sends the geometry, which must match the layers
+    if(const auto error = w->chain.resize(static_cast<std::size_t>(width), static_cast<std::size_t>(height)))
+    {
+        return; // The compositor is answered with the current size
+    }
+
     w->info.size = {width, height};
+    w->dirty.clip(w->info.size);
 }
 
 void close(void* /*data*/, xdg_toplevel* /*xdg_toplevel*/) noexcept
@@ -153,30 +320,37 @@ void close(void* /*data*/, xdg_toplevel* /*xdg_toplevel*/) noexcept
 namespace listener
 {
 
+using protocol_stats::counted;
+
+constexpr wl_callback_listener frame = {
+    .done = counted<&wl_callback_listener::done, callback::frame::done>,
+};
+
 namespace seat
 {
 
+// Input is not handled yet, events are only counted
 constexpr wl_pointer_listener pointer{
-    .enter                   = {},
-    .leave                   = {},
-    .motion                  = {},
-    .button                  = {},
-    .axis                    = {},
-    .frame                   = {},
-    .axis_source             = {},
-    .axis_stop               = {},
-    .axis_discrete           = {},
-    .axis_value120           = {},
-    .axis_relative_direction = {},
+    .enter                   = counted<&wl_pointer_listener::enter>,
+    .leave                   = counted<&wl_pointer_listener::leave>,
+    .motion                  = counted<&wl_pointer_listener::motion>,
+    .button                  = counted<&wl_pointer_listener::button>,
+    .axis                    = counted<&wl_pointer_listener::axis>,
+    .frame                   = counted<&wl_pointer_listener::frame>,
+    .axis_source             = counted<&wl_pointer_listener::axis_source>,
+    .axis_stop               = counted<&wl_pointer_listener::axis_stop>,
+    .axis_discrete           = counted<&wl_pointer_listener::axis_discrete>,
+    .axis_value120           = counted<&wl_pointer_listener::axis_value120>,
+    .axis_relative_direction = counted<&wl_pointer_listener::axis_relative_direction>,
 };
 
 constexpr wl_keyboard_listener keyboard{
-    .keymap      = {},
-    .enter       = {},
-    .leave       = {},
-    .key         = {},
-    .modifiers   = {},
-    .repeat_info = {},
+    .keymap      = counted<&wl_keyboard_listener::keymap>,
+    .enter       = counted<&wl_keyboard_listener::enter>,
+    .leave       = counted<&wl_keyboard_listener::leave>,
+    .key         = counted<&wl_keyboard_listener::key>,
+    .modifiers   = counted<&wl_keyboard_listener::modifiers>,
+    .repeat_info = counted<&wl_keyboard_listener::repeat_info>,
 };
 
 } // namespace seat
@@ -185,46 +359,155 @@ namespace xdg
 {
 
 constexpr xdg_surface_listener surface = {
-    .configure = callback::xdg::surface::configure,
+    .configure = counted<&xdg_surface_listener::configure, callback::xdg::surface::configure>,
 };
 
-constexpr xdg_toplevel_listener toplevel{.configure = callback::xdg::toplevel::configure, .close = callback::xdg::toplevel::close};
+// xdg_wm_base is bound up to version 6: every event up to this version needs an entry. Bounds and capabilities are not used yet
+constexpr xdg_toplevel_listener toplevel{
+    .configure        = counted<&xdg_toplevel_listener::configure, callback::xdg::toplevel::configure>,
+    .close            = counted<&xdg_toplevel_listener::close, callback::xdg::toplevel::close>,
+    .configure_bounds = counted<&xdg_toplevel_listener::configure_bounds>,
+    .wm_capabilities  = counted<&xdg_toplevel_listener::wm_capabilities>,
+};
 
 } // namespace xdg
 
 } // namespace listener
 
+/// Requests a frame event, unless one is pending already. Takes effect with the next commit.
+void schedule_frame(window::components& c) noexcept
+{
+    if(c.frame != nullptr)
+    {
+        return;
+    }
+
+    c.frame = protocol_stats::send<WL_SURFACE_FRAME>(wl_surface_frame, c.surface.handle());
+
+    if(c.frame != nullptr)
+    {
+        wl_callback_add_listener(c.frame, std::addressof(listener::frame), std::addressof(c));
+    }
+}
+
 } // namespace
 
 [[nodiscard]]
-std::optional<window::any_call_info> window::create(display& parent) noexcept
+std::optional<window::any_call_info> window::create(display& parent, configure_policy configure) noexcept
 {
-    constexpr auto all_black = 0x00;
-
-    std::ranges::fill(m_components.buffer.memory(), std::byte{all_black});
+    // Feedback objects are created from the wrapper, so that their events are on the queue of the window
+    m_components.presentation_time = components::globals(parent, m_components.queue).presentation;
+    m_components.presented         = presentation_log{parent.presentation_clock()};
 
     xdg_surface_add_listener(m_components.surface.xdg_handle(), std::addressof(listener::xdg::surface), std::addressof(m_components));
 
-    xdg_surface_set_window_geometry(m_components.surface.xdg_handle(),
-                                    m_components.info.coordinates.x,
-                                    m_components.info.coordinates.y,
-                                    m_components.info.size.width,
-                                    m_components.info.size.height);
+    protocol_stats::send<XDG_SURFACE_SET_WINDOW_GEOMETRY>(xdg_surface_set_window_geometry,
+                                                          m_components.surface.xdg_handle(),
+                                                          m_components.info.coordinates.x,
+                                                          m_components.info.coordinates.y,
+                                                          m_components.info.size.width,
+                                                          m_components.info.size.height);
 
     xdg_toplevel_add_listener(m_components.toplevel.handle(), std::addressof(listener::xdg::toplevel), std::addressof(m_components));
 
-    xdg_toplevel_set_title(m_components.toplevel.handle(), m_components.info.title.c_str());
+    protocol_stats::send<XDG_TOPLEVEL_SET_TITLE>(xdg_toplevel_set_title, m_components.toplevel.handle(), m_components.info.title.c_str());
 
     wl_pointer_add_listener(m_components.inputs.parts().mouse.handle(), std::addressof(listener::seat::pointer), std::addressof(m_components));
 
     wl_keyboard_add_listener(m_components.inputs.parts().keyboard.handle(), std::addressof(listener::seat::keyboard), std::addressof(m_components));
 
-    wl_surface_commit(m_components.surface.handle());
-    wl_display_roundtrip(parent.handle());
+    protocol_stats::send<WL_SURFACE_COMMIT>(wl_surface_commit, m_components.surface.handle());
+
+    // Sent with the next flush, by the dispatch loop. See configured
+    if(configure == configure_policy::defer)
+    {
+        return {};
+    }
+
+    // The initial configure event is on the queue of the window
+    if(m_components.queue)
+    {
+        m_components.queue->roundtrip();
+    }
+    else
+    {
+        parent.roundtrip();
+    }
 
     return {};
 }
 
+void window::request_frame(frame_callback callback) noexcept
+{
+    m_components.on_frame = std::move(callback);
+
+    schedule_frame(m_components);
+    commit(m_components);
+}
+
+void window::animate(frame_callback step) noexcept
+{
+    const bool running = static_cast<bool>(m_components.animation);
+
+    m_components.animation = std::move(step);
+
+    // The pending frame event, if any, drives the loop already
+    if(not running and m_components.animation)
+    {
+        schedule_frame(m_components);
+        commit(m_components);
+    }
+}
+
+void window::apply() noexcept
+{
+    auto& batch = m_components.batch;
+
+    if(batch.depth == 0 or --batch.depth > 0)
+    {
+        return;
+    }
+
+    const auto staged = std::exchange(batch, {});
+
+    if(staged.geometry)
+    {
+        set_geometry(m_components);
+    }
+
+    if(staged.redraws > 0)
+    {
+        std::ignore = redraw(m_components);
+        m_transaction_stats.redraws_saved += staged.redraws - 1;
+    }
+
+    if(staged.commits > 0)
+    {
+        commit(m_components);
+
+        ++m_transaction_stats.commits;
+        m_transaction_stats.commits_saved += staged.commits - 1;
+    }
+
+    ++m_transaction_stats.applied;
+}
+
+int window::dispatch_queue() noexcept
+{
+    if(m_components.queue)
+    {
+        return m_components.queue->dispatch();
+    }
+
+    protocol_stats::flush(m_components.connection);
+    return wl_display_dispatch(m_components.connection);
+}
+
+int window::dispatch_queue_pending() noexcept
+{
+    return m_components.queue ? m_components.queue->dispatch_pending() : wl_display_dispatch_pending(m_components.connection);
+}
+
 void window::show() noexcept {}
 void window::hide() noexcept {}
 void window::close() noexcept {}
@@ -234,7 +517,40 @@ void window::set_opacity(float o) noexcept
 {
     m_components.info.opacity = std::clamp(o, 0.f, 1.f);
 
-    apply_opacity(m_components);
+    if(const auto f = components::format(m_components.info.opacity); f != m_components.chain.format())
+    {
+        if(const auto error = m_components.chain.reformat(f))
+        {
+            return;
+        }
+    }
+
+    m_components.dirty.add_all();
+
+    if(redraw(m_components))
+    {
+        commit(m_components);
+    }
+}
+
+void window::set_draw(tile_renderer::draw_callback draw) noexcept
+{
+    m_components.draw = std::move(draw);
+
+    if(m_components.draw and not m_components.renderer)
+    {
+        if(auto renderer = tile_renderer::make({}))
+        {
+            m_components.renderer = *std::move(renderer);
+        }
+    }
+
+    m_components.dirty.add_all();
+
+    if(redraw(m_components))
+    {
+        commit(m_components);
+    }
 }
 
 void window::move(position2d p) noexcept
@@ -243,12 +559,8 @@ void window::move(position2d p) noexcept
     // TODO: may not be supported
     m_components.info.coordinates = p;
 
-    xdg_surface_set_window_geometry(m_components.surface.xdg_handle(),
-                                    m_components.info.coordinates.x,
-                                    m_components.info.coordinates.y,
-                                    m_components.info.size.width,
-                                    m_components.info.size.height);
-    wl_surface_commit(m_components.surface.handle());
+    set_geometry(m_components);
+    commit(m_components);
 }
 
 void window::resize(dimension2d d) noexcept
@@ -257,53 +569,27 @@ void window::resize(dimension2d d) noexcept
 
     if(d != m_components.info.size)
     {
-        constexpr std::size_t format_stride = 4; // 32-bit, 4 bytes
-
-        if(static_cast<std::size_t>(d.width * d.height) * format_stride > m_components.pool.size_bytes())
+        if(const auto error = m_components.chain.resize(static_cast<std::size_t>(d.width), static_cast<std::size_t>(d.height)))
         {
             return; // return not supported
         }
 
         m_components.info.size = d;
+        m_components.dirty.clip(d);
+        m_components.dirty.add_all();
 
-        {
-            auto new_buffer = shm_buffer::make(m_components.pool, {.index = 0, .width = d.width, .height = d.height});
-
-            if(not new_buffer)
-            {
-                return; // return not supported
-            }
-
-            m_components.buffer = *std::move(new_buffer);
-        }
-
-        // Re-give the buffer some data
-        {
-            constexpr auto all_black = 0x00;
-
-            // auto* const data = reinterpret_cast<std::uint32_t*>(c.buffers.front().memory().data());
-            std::ranges::fill(m_components.buffer.memory(), std::byte{all_black});
-
-            apply_opacity(m_components);
-        }
-
-        wl_surface_attach(m_components.surface.handle(), m_components.buffer.handle(), 0, 0);
+        std::ignore = redraw(m_components);
 
-        xdg_surface_set_window_geometry(m_components.surface.xdg_handle(),
-                                        m_components.info.coordinates.x,
-                                        m_components.info.coordinates.y,
-                                        m_components.info.size.width,
-                                        m_components.info.size.height);
-        apply_opacity(m_components);
-        wl_surface_commit(m_components.surface.handle());
+        set_geometry(m_components);
+        commit(m_components);
     }
 }
 
 void window::rename(std::string name)
 {
     m_components.info.title = std::move(name);
-    xdg_toplevel_set_title(m_components.toplevel.handle(), m_components.info.title.c_str());
-    wl_surface_commit(m_components.surface.handle());
+    protocol_stats::send<XDG_TOPLEVEL_SET_TITLE>(xdg_toplevel_set_title, m_components.toplevel.handle(), m_components.info.title.c_str());
+    commit(m_components);
 }
 
 } // namespace fubuki::io::platform::linux_bsd::wayland
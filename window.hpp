@@ -29,19 +29,29 @@
 #ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_WINDOW_HPP
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_WINDOW_HPP
 
+#include "damage_region.hpp"
 #include "decoration.hpp"
 #include "display.hpp"
-#include "registry.hpp"
-#include "screen.hpp"
+#include "event_queue.hpp"
+#include "frame_recorder.hpp"
+#include "presentation_log.hpp"
 #include "seat.hpp"
 #include "shm_buffer.hpp"
+#include "swapchain.hpp"
+#include "tile_renderer.hpp"
 #include "window_info.hpp"
 #include "xdg/surface.hpp"
 #include "xdg/toplevel.hpp"
 #include "xdg/wm_base.hpp"
 
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <ostream>
 #include <utility>
+#include <vector>
 
 #include <wayland-client.h>
 
@@ -57,39 +67,46 @@ class window
 
 public:
 
-    class components
+    /// Where the events of a window are dispatched.
+    enum class queue_policy
     {
-        [[nodiscard]] static auto construct_pool(display& parent)
-        {
-            const auto available_screens = screen::enumerate(parent);
+        shared,    ///< On the default queue of the display, along with the other windows.
+        dedicated, ///< On a queue of its own, which can be dispatched from another thread. See dispatch_queue.
+    };
 
-            // if(not available_screens){throw call_exception{available_screens.error()};}
+    /// Whether creating a window waits for its first configure event.
+    enum class configure_policy
+    {
+        wait,  ///< Roundtrips until the window is configured and drawn for the first time.
+        defer, ///< Returns at once. The window is drawn when configured: nothing may be drawn or committed until then. See configured.
+    };
 
-            std::size_t width  = 0;
-            std::size_t height = 0;
+    /// Called when the compositor wants a new frame, with a timestamp in milliseconds of an undefined base.
+    using frame_callback = std::function<void(std::uint32_t time)>;
 
-            for(const auto& s : available_screens)
+    class components
+    {
+        [[nodiscard]] static std::optional<event_queue> construct_queue(display& parent, queue_policy policy)
+        {
+            if(policy == queue_policy::shared)
             {
-                width += s.area.extent.width;
-                height += s.area.extent.height;
+                return std::nullopt;
             }
 
-            width  = std::max(std::size_t{1}, width);
-            height = std::max(std::size_t{1}, height);
-
-            return shm_pool{
-                parent, {.width = width, .height = height, .layers = 1}
-            };
+            return std::optional<event_queue>{std::in_place, parent};
         }
 
-        [[nodiscard]] auto construct_buffer(const window_info& i)
+        [[nodiscard]] static auto construct_swapchain(display& parent, const window_info& i, swapchain::mode presentation, wl_event_queue* q)
         {
-            return shm_buffer{
-                pool,
+            return swapchain{
+                parent.arena(),
                 {
-                  .index  = 0,
-                  .width  = i.size.width,
-                  .height = i.size.height,
+                  .width               = static_cast<std::size_t>(i.size.width),
+                  .height              = static_cast<std::size_t>(i.size.height),
+                  .presentation        = presentation,
+                  .format              = format(i.opacity),
+                  .background_prefault = true, // Overlaps with the roundtrip of window::create
+                  .queue               = q,
                   }
             };
         }
@@ -119,6 +136,18 @@ public:
 
     public:
 
+        /// Returns the globals the proxies of a window are created from: wrappers bound to its queue, if it has one.
+        [[nodiscard]] static const display::global& globals(display& parent, const std::optional<event_queue>& q) noexcept
+        {
+            return q ? q->globals() : parent.globals();
+        }
+
+        /// Returns the format of the layers of a window: opaque windows do not carry an alpha channel, so that the compositor skips blending.
+        [[nodiscard]] static constexpr wl_shm_format format(float opacity) noexcept
+        {
+            return (opacity < 1.f) ? WL_SHM_FORMAT_ARGB8888 : WL_SHM_FORMAT_XRGB8888;
+        }
+
         struct event_state
         {
             struct seat
@@ -162,8 +191,19 @@ public:
             seat inputs = {};
         };
 
-        shm_pool                  pool;
-        shm_buffer                buffer;
+        /// Changes deferred while a transaction is open. See window::begin.
+        struct batch_state
+        {
+            std::uint32_t depth    = 0;     ///< Number of nested transactions.
+            std::size_t   commits  = 0;     ///< Commits requested since the outermost transaction began.
+            std::size_t   redraws  = 0;     ///< Redraws requested since the outermost transaction began.
+            bool          geometry = false; ///< True if the window geometry changed.
+        };
+
+        std::optional<event_queue> queue;      ///< Declared first: destroyed after the proxies it holds.
+        wl_display*                connection; ///< Dispatched when the window does not have a queue of its own.
+
+        swapchain                 chain;
         xdg::wm_base              wm_base;
         xdg::surface              surface;
         xdg::toplevel             toplevel;
@@ -172,31 +212,62 @@ public:
         window_info               info;
         window_state              state;
         event_state               internal_state;
+        batch_state               batch;
+        damage_region             dirty; ///< Damage posted with the next commit, in buffer coordinates.
 
-        components(display& parent, window_info i)
-            : pool{construct_pool(parent)},
-              buffer{construct_buffer(i)},
-              wm_base{parent},
+        tile_renderer::draw_callback draw;     ///< Draws the content of the window over its background. Optional.
+        std::optional<tile_renderer> renderer; ///< Runs draw, created along with it. Frames are drawn on the calling thread without it.
+
+        wl_callback*   frame;     ///< Pending wl_surface.frame request, if any.
+        frame_callback on_frame;  ///< Called once by the next frame event.
+        frame_callback animation; ///< Called by every frame event, before the window is redrawn. Set while animating.
+
+        wp_presentation* presentation_time; ///< Feedback is requested with every commit when the compositor supports it.
+        presentation_log presented;         ///< What became of the last commits.
+        frame_recorder   frame_times;       ///< Render times of the frames and intervals between commits.
+
+        bool                                 configured;        ///< True once the first configure event was handled.
+        std::vector<std::coroutine_handle<>> configure_waiters; ///< Coroutines resumed by the first configure event.
+
+        components(display& parent, window_info i, swapchain::mode presentation, queue_policy policy)
+            : queue{construct_queue(parent, policy)},
+              connection{parent.handle()},
+              chain{construct_swapchain(parent, i, presentation, queue ? queue->handle() : nullptr)},
+              wm_base{parent, globals(parent, queue)},
               surface{construct_surface()},
               toplevel{construct_toplevel()},
-              inputs{parent},
+              inputs{globals(parent, queue)},
               deco{construct_decoration(parent, i)},
               info{std::move(i)},
               state{},
-              internal_state{}
+              internal_state{},
+              batch{},
+              dirty{info.size},
+              draw{},
+              renderer{},
+              frame{nullptr},
+              on_frame{},
+              animation{},
+              presentation_time{nullptr},
+              presented{},
+              frame_times{},
+              configured{false},
+              configure_waiters{}
         {
         }
 
-        components(shm_pool                  p,
-                   shm_buffer                buf,
-                   xdg::wm_base              xm,
-                   xdg::surface              surf,
-                   xdg::toplevel             top,
-                   seat                      in,
-                   std::optional<decoration> dec,
-                   window_info               i) noexcept
-            : pool{std::move(p)},
-              buffer{std::move(buf)},
+        components(std::optional<event_queue> q,
+                   wl_display*                c,
+                   swapchain                  sc,
+                   xdg::wm_base               xm,
+                   xdg::surface               surf,
+                   xdg::toplevel              top,
+                   seat                       in,
+                   std::optional<decoration>  dec,
+                   window_info                i) noexcept
+            : queue{std::move(q)},
+              connection{c},
+              chain{std::move(sc)},
               wm_base{std::move(xm)},
               surface{std::move(surf)},
               toplevel{std::move(top)},
@@ -204,13 +275,26 @@ public:
               deco{std::move(dec)},
               info{std::move(i)},
               state{},
-              internal_state{}
+              internal_state{},
+              batch{},
+              dirty{info.size},
+              draw{},
+              renderer{},
+              frame{nullptr},
+              on_frame{},
+              animation{},
+              presentation_time{nullptr},
+              presented{},
+              frame_times{},
+              configured{false},
+              configure_waiters{}
         {
         }
 
         components(components&& other) noexcept
-            : pool{std::move(other.pool)},
-              buffer{std::move(other.buffer)},
+            : queue{std::move(other.queue)},
+              connection{std::exchange(other.connection, nullptr)},
+              chain{std::move(other.chain)},
               wm_base{std::move(other.wm_base)},
               surface{std::move(other.surface)},
               toplevel{std::move(other.toplevel)},
@@ -218,12 +302,29 @@ public:
               deco{std::move(other.deco)},
               info{std::move(other.info)},
               state{std::exchange(other.state, window_state{})},
-              internal_state{std::exchange(other.internal_state, event_state{})}
+              internal_state{std::exchange(other.internal_state, event_state{})},
+              batch{std::exchange(other.batch, batch_state{})},
+              dirty{std::exchange(other.dirty, damage_region{})},
+              draw{std::move(other.draw)},
+              renderer{std::move(other.renderer)},
+              frame{std::exchange(other.frame, nullptr)},
+              on_frame{std::move(other.on_frame)},
+              animation{std::move(other.animation)},
+              presentation_time{std::exchange(other.presentation_time, nullptr)},
+              presented{std::move(other.presented)},
+              frame_times{std::exchange(other.frame_times, frame_recorder{})},
+              configured{std::exchange(other.configured, false)},
+              configure_waiters{std::move(other.configure_waiters)}
         {
             xdg_surface_set_user_data(surface.xdg_handle(), this);
             xdg_toplevel_set_user_data(toplevel.handle(), this);
             wl_pointer_set_user_data(inputs.parts().mouse.handle(), this);
             wl_keyboard_set_user_data(inputs.parts().keyboard.handle(), this);
+
+            if(frame != nullptr)
+            {
+                wl_callback_set_user_data(frame, this);
+            }
         }
 
         components& operator=(components&& other) noexcept
@@ -235,12 +336,19 @@ public:
         components(const components&)            = delete;
         components& operator=(const components&) = delete;
 
-        ~components() noexcept = default;
+        ~components() noexcept
+        {
+            if(frame != nullptr)
+            {
+                wl_callback_destroy(frame);
+            }
+        }
 
         void swap(components& other) noexcept
         {
-            pool.swap(other.pool);
-            buffer.swap(other.buffer);
+            queue.swap(other.queue);
+            std::swap(connection, other.connection);
+            chain.swap(other.chain);
             wm_base.swap(other.wm_base);
             surface.swap(other.surface);
             toplevel.swap(other.toplevel);
@@ -249,6 +357,18 @@ public:
             info.swap(other.info);
             state.swap(other.state);
             std::swap(internal_state, other.internal_state);
+            std::swap(batch, other.batch);
+            dirty.swap(other.dirty);
+            draw.swap(other.draw);
+            renderer.swap(other.renderer);
+            std::swap(frame, other.frame);
+            on_frame.swap(other.on_frame);
+            animation.swap(other.animation);
+            std::swap(presentation_time, other.presentation_time);
+            presented.swap(other.presented);
+            std::swap(frame_times, other.frame_times);
+            std::swap(configured, other.configured);
+            configure_waiters.swap(other.configure_waiters);
 
             xdg_surface_set_user_data(surface.xdg_handle(), this);
             xdg_surface_set_user_data(other.surface.xdg_handle(), std::addressof(other));
@@ -260,6 +380,14 @@ public:
             wl_pointer_set_user_data(other.inputs.parts().mouse.handle(), std::addressof(other));
 
             wl_keyboard_set_user_data(other.inputs.parts().keyboard.handle(), std::addressof(other));
+
+            for(auto* c : {this, std::addressof(other)})
+            {
+                if(c->frame != nullptr)
+                {
+                    wl_callback_set_user_data(c->frame, c);
+                }
+            }
         }
 
         friend void swap(components& a, components& b) noexcept { a.swap(b); }
@@ -269,9 +397,49 @@ public:
     {
     };
 
-    window(display& parent, window_info i) : m_registry{parent}, m_components{parent, std::move(i)}
+    /// Counters of the changes transactions merged.
+    struct transaction_statistics
     {
-        if(const auto error = create(parent))
+        std::size_t applied       = 0; ///< Transactions applied.
+        std::size_t commits       = 0; ///< wl_surface.commit requests sent by transactions.
+        std::size_t commits_saved = 0; ///< wl_surface.commit requests merged into the commit of a transaction.
+        std::size_t redraws_saved = 0; ///< Frames not drawn because a later change of the same transaction replaced them.
+
+        template<typename char_type, typename traits = std::char_traits<char_type>>
+        friend std::basic_ostream<char_type, traits>& operator<<(std::basic_ostream<char_type, traits>& out, const transaction_statistics& s)
+        {
+            return out << "transactions:{applied: " << s.applied << ", commits: " << s.commits << ", commits saved: " << s.commits_saved
+                       << ", redraws saved: " << s.redraws_saved << "}";
+        }
+    };
+
+    /// Opens a transaction on construction, and applies it on destruction. See window::begin.
+    class transaction
+    {
+    public:
+
+        explicit transaction(window& w) noexcept : m_window{std::addressof(w)} { m_window->begin(); }
+
+        transaction(const transaction&)            = delete;
+        transaction& operator=(const transaction&) = delete;
+        transaction(transaction&&)                 = delete;
+        transaction& operator=(transaction&&)      = delete;
+
+        ~transaction() noexcept { m_window->apply(); }
+
+    private:
+
+        window* m_window;
+    };
+
+    window(display&         parent,
+           window_info      i,
+           swapchain::mode  presentation = swapchain::mode::double_buffering,
+           queue_policy     policy       = queue_policy::shared,
+           configure_policy configure    = configure_policy::wait)
+        : m_components{parent, std::move(i), presentation, policy}
+    {
+        if(const auto error = create(parent, configure))
         {
             throw std::runtime_error("Wayland surface creation failed");
         }
@@ -280,7 +448,9 @@ public:
     window(const window&)            = delete;
     window& operator=(const window&) = delete;
 
-    window(window&& other) noexcept : m_registry{std::move(other.m_registry)}, m_components{std::move(other.m_components)}
+    window(window&& other) noexcept
+        : m_components{std::move(other.m_components)},
+          m_transaction_stats{std::exchange(other.m_transaction_stats, transaction_statistics{})}
     {
         xdg_surface_set_user_data(m_components.surface.xdg_handle(), std::addressof(m_components));
     }
@@ -293,31 +463,43 @@ public:
 
     ~window() noexcept = default;
 
-    [[nodiscard]] static std::expected<window, any_call_info> make(display& parent, window_info i) noexcept
+    [[nodiscard]] static std::expected<window, any_call_info>
+    make(display&         parent,
+         window_info      i,
+         swapchain::mode  presentation = swapchain::mode::double_buffering,
+         queue_policy     policy       = queue_policy::shared,
+         configure_policy configure    = configure_policy::wait) noexcept
     {
-        auto r = registry::make(parent);
+        std::optional<event_queue> queue = {};
 
-        if(not r)
+        if(policy == queue_policy::dedicated)
         {
-            return std::unexpected{any_call_info{}};
-        }
+            auto q = event_queue::make(parent);
 
-        auto pool = shm_pool::make(parent,
-                                   {.width = static_cast<std::size_t>(i.size.width), .height = static_cast<std::size_t>(i.size.height), .layers = 1});
+            if(not q)
+            {
+                return std::unexpected{any_call_info{}};
+            }
 
-        if(not pool)
-        {
-            return std::unexpected{any_call_info{}};
+            queue = *std::move(q);
         }
 
-        auto buffer = shm_buffer::make(*pool, {.index = 0, .width = i.size.width, .height = i.size.height});
+        const auto& globals = components::globals(parent, queue);
 
-        if(not buffer)
+        auto chain = swapchain::make(parent.arena(),
+                                     {.width               = static_cast<std::size_t>(i.size.width),
+                                      .height              = static_cast<std::size_t>(i.size.height),
+                                      .presentation        = presentation,
+                                      .format              = components::format(i.opacity),
+                                      .background_prefault = true,
+                                      .queue               = queue ? queue->handle() : nullptr});
+
+        if(not chain)
         {
             return std::unexpected{any_call_info{}};
         }
 
-        auto wm_base = xdg::wm_base::make(parent);
+        auto wm_base = xdg::wm_base::make(parent, globals);
 
         if(not wm_base)
         {
@@ -338,7 +520,7 @@ public:
             return std::unexpected{any_call_info{}};
         }
 
-        auto inputs = seat::make(parent);
+        auto inputs = seat::make(globals);
 
         if(not inputs)
         {
@@ -351,7 +533,7 @@ public:
         // the general agreement on desktop is that windows should have at least a close button
 
         // Not supported on GNOME as of the time of writing
-        if(parent.globals().decoration_manager != nullptr)
+        if(globals.decoration_manager != nullptr)
         {
             auto ssd = decoration::server_side::make(*toplevel);
 
@@ -369,9 +551,9 @@ public:
         }
 
         auto result = window{token{},
-                             *std::move(r),
-                             *std::move(pool),
-                             *std::move(buffer),
+                             std::move(queue),
+                             parent.handle(),
+                             *std::move(chain),
                              *std::move(wm_base),
                              *std::move(surface),
                              *std::move(toplevel),
@@ -379,7 +561,7 @@ public:
                              std::move(deco),
                              std::move(i)};
 
-        if(const auto error = result.create(parent))
+        if(const auto error = result.create(parent, configure))
         {
             return std::unexpected{any_call_info{}};
         }
@@ -392,8 +574,7 @@ public:
     [[nodiscard]] auto*       xdg_handle() noexcept { return m_components.surface.xdg_handle(); }
     [[nodiscard]] const auto* xdg_handle() const noexcept { return m_components.surface.xdg_handle(); }
 
-    [[nodiscard]] const auto& pool() const noexcept { return m_components.pool; }
-    [[nodiscard]] const auto& buffer() const noexcept { return m_components.buffer; }
+    [[nodiscard]] const auto& chain() const noexcept { return m_components.chain; }
     [[nodiscard]] const auto& wm_base() const noexcept { return m_components.wm_base; }
     [[nodiscard]] const auto& surface() const noexcept { return m_components.surface; }
     [[nodiscard]] const auto& toplevel() const noexcept { return m_components.toplevel; }
@@ -408,10 +589,146 @@ public:
     void resize(dimension2d d) noexcept;
     void rename(std::string name);
 
+    /**
+     * Marks a region of the window as changed, in buffer coordinates. The region is clipped to the window and posted to the compositor
+     * with the next commit, so that it only uploads and blends these areas. The window still repaints every pixel of the next frame: the
+     * region must cover every pixel the draw callback changes. Frames drawn without any damage marked post the whole window, as do
+     * resizes and changes of opacity or draw callback.
+     */
+    void damage(rectangle2d r) noexcept { m_components.dirty.add(r); }
+
+    /**
+     * Sets the callback drawing the content of the window, then redraws it. The callback runs on a pool of threads, one tile at a time,
+     * over a background already cleared, and the frame is committed once every tile is drawn.
+     * If the threads cannot be started, the callback is called once per frame with the whole window as a single tile.
+     * @see tile_renderer
+     */
+    void set_draw(tile_renderer::draw_callback draw) noexcept;
+
+    /**
+     * Calls a function once, when the compositor wants the next frame of the window, and commits the surface so that the request takes
+     * effect. Replaces the function of a pending request. The compositor may never call back, for example while the window is hidden.
+     */
+    void request_frame(frame_callback callback) noexcept;
+
+    /// Awaitable of configured.
+    class configure_awaitable
+    {
+    public:
+
+        explicit configure_awaitable(components& c) noexcept : m_components{std::addressof(c)} {}
+
+        [[nodiscard]] bool await_ready() const noexcept { return m_components->configured; }
+
+        void await_suspend(std::coroutine_handle<> h) { m_components->configure_waiters.push_back(h); }
+
+        void await_resume() const noexcept {}
+
+    private:
+
+        components* m_components;
+    };
+
+    /// Awaitable of next_frame.
+    class frame_awaitable
+    {
+    public:
+
+        explicit frame_awaitable(window& w) noexcept : m_window{std::addressof(w)} {}
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) noexcept
+        {
+            m_window->request_frame(
+                [this, h](std::uint32_t time)
+                {
+                    m_time = time;
+                    h.resume();
+                });
+        }
+
+        /// Returns the timestamp of the frame event.
+        [[nodiscard]] std::uint32_t await_resume() const noexcept { return m_time; }
+
+    private:
+
+        window*       m_window;
+        std::uint32_t m_time = 0;
+    };
+
+    /**
+     * Returns an awaitable that resumes once the window handled its first configure event and was drawn, or at once if it already did.
+     * Created with configure_policy::defer, many windows can wait for their configure events at the same time, on a single thread.
+     * The coroutine is resumed from the dispatch of the queue of the window, inside the configure event.
+     */
+    [[nodiscard]] configure_awaitable configured() noexcept { return configure_awaitable{m_components}; }
+
+    /**
+     * Returns an awaitable that resumes with the timestamp of the next frame event, like request_frame, which it uses: only one frame can be
+     * awaited at a time, and a later request_frame orphans the coroutine. The coroutine is resumed inside the frame event, from the dispatch
+     * of the queue of the window, once the window is done handling it. It must not move or destroy the window before its next suspension
+     * either: the awaitable points to the window.
+     */
+    [[nodiscard]] frame_awaitable next_frame() noexcept { return frame_awaitable{*this}; }
+
+    /**
+     * Redraws the window at the pace of the compositor: on each frame event, calls step, redraws the window and requests the next frame.
+     * Exactly one frame is drawn per refresh of the output, and nothing at all runs while the compositor withholds frame events, for
+     * example while the window is occluded.
+     * @param step Called before each frame is drawn, with the timestamp of the frame event. Typically advances the state the draw callback
+     * reads.
+     */
+    void animate(frame_callback step) noexcept;
+
+    /// Stops animating after the current frame. A pending request_frame is not affected.
+    void stop_animation() noexcept { m_components.animation = {}; }
+
+    /**
+     * Blocks until events for this window are available, then dispatches them.
+     * Windows with a dedicated queue only dispatch their own events, and may do so from their own thread. Other windows dispatch the
+     * default queue of the display, with the events of every other shared window.
+     * @returns The number of dispatched events, or -1 on error.
+     */
+    int dispatch_queue() noexcept;
+
+    /// Same as dispatch_queue, without blocking: only dispatches the events already read from the display.
+    int dispatch_queue_pending() noexcept;
+
+    /**
+     * Returns the outcome of the last commits of the window, as reported by the compositor: commit-to-present latency, discarded frames
+     * and missed refreshes. Empty if the compositor does not support wp_presentation.
+     */
+    [[nodiscard]] const presentation_log& presented() const noexcept { return m_components.presented; }
+
+    /**
+     * Opens a transaction: until the matching apply, changes to the window (move, resize, rename, set_opacity, set_draw, damage...) are
+     * staged instead of being committed one by one. Transactions nest, and only the outermost one commits.
+     * @see transaction
+     */
+    void begin() noexcept { ++m_components.batch.depth; }
+
+    /**
+     * Closes a transaction. When the outermost one closes, the window is redrawn once if any staged change required it, and every staged
+     * change is sent with a single wl_surface.commit, so that the compositor applies them atomically and repaints once.
+     */
+    void apply() noexcept;
+
+    [[nodiscard]] const auto& transaction_stats() const noexcept { return m_transaction_stats; }
+
+    /// Returns the percentiles of the render times of the frames of the window, and of the intervals between its commits. Does not allocate.
+    [[nodiscard]] frame_recorder::statistics frame_stats() const noexcept { return m_components.frame_times.stats(); }
+
+    /// Forgets the recorded frame times, for example before an animation, so that idle periods do not count as intervals.
+    void reset_frame_stats() noexcept { m_components.frame_times.reset(); }
+
+    /// Returns true if the window has an event queue of its own.
+    [[nodiscard]] bool has_queue() const noexcept { return m_components.queue.has_value(); }
+
     void swap(window& other) noexcept
     {
-        m_registry.swap(other.m_registry);
         m_components.swap(other.m_components);
+        std::swap(m_transaction_stats, other.m_transaction_stats);
 
         xdg_surface_set_user_data(m_components.surface.xdg_handle(), std::addressof(m_components));
         xdg_surface_set_user_data(other.m_components.surface.xdg_handle(), std::addressof(other.m_components));
@@ -422,19 +739,19 @@ public:
 private:
 
     window(token,
-           registry                  r,
-           shm_pool                  pool,
-           shm_buffer                buffer,
-           xdg::wm_base              wm_base,
-           xdg::surface              surface,
-           xdg::toplevel             toplevel,
-           seat                      inputs,
-           std::optional<decoration> deco,
-           window_info               i) noexcept
-        : m_registry{std::move(r)},
-          m_components{
-              std::move(pool),
-              std::move(buffer),
+           std::optional<event_queue> queue,
+           wl_display*                connection,
+           swapchain                  chain,
+           xdg::wm_base               wm_base,
+           xdg::surface               surface,
+           xdg::toplevel              toplevel,
+           seat                       inputs,
+           std::optional<decoration>  deco,
+           window_info                i) noexcept
+        : m_components{
+              std::move(queue),
+              connection,
+              std::move(chain),
               std::move(wm_base),
               std::move(surface),
               std::move(toplevel),
@@ -446,10 +763,10 @@ private:
     }
 
     [[nodiscard]]
-    std::optional<any_call_info> create(display& parent) noexcept;
+    std::optional<any_call_info> create(display& parent, configure_policy configure) noexcept;
 
-    registry   m_registry;
-    components m_components;
+    components             m_components;
+    transaction_statistics m_transaction_stats = {};
 };
 
 } // namespace fubuki::io::platform::linux_bsd::wayland
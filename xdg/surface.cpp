@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "../protocol_stats.hpp"
 #include "generated/shell-client-protocol.hpp"
 #include "surface.hpp"
 
@@ -35,14 +36,14 @@ namespace fubuki::io::platform::linux_bsd::wayland::xdg
 [[nodiscard]]
 auto surface::create(wm_base& parent) noexcept -> std::optional<any_call_info>
 {
-    m_handle = wl_compositor_create_surface(parent.globals().compositor);
+    m_handle = protocol_stats::send<WL_COMPOSITOR_CREATE_SURFACE>(wl_compositor_create_surface, parent.globals().compositor);
 
     if(m_handle == nullptr)
     {
         return any_call_info{};
     }
 
-    m_xdg_handle = xdg_wm_base_get_xdg_surface(parent.handle(), m_handle);
+    m_xdg_handle = protocol_stats::send<XDG_WM_BASE_GET_XDG_SURFACE>(xdg_wm_base_get_xdg_surface, parent.handle(), m_handle);
 
     if(m_xdg_handle == nullptr)
     {
@@ -29,6 +29,7 @@
 #ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_XDG_SURFACE_HPP
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_XDG_SURFACE_HPP
 
+#include "../protocol_stats.hpp"
 #include "generated/shell-client-protocol.hpp"
 #include "wm_base.hpp"
 
@@ -80,12 +81,12 @@ public:
     {
         if(m_xdg_handle != nullptr)
         {
-            xdg_surface_destroy(m_xdg_handle);
+            protocol_stats::send<XDG_SURFACE_DESTROY>(xdg_surface_destroy, m_xdg_handle);
         }
 
         if(m_handle != nullptr)
         {
-            wl_surface_destroy(m_handle);
+            protocol_stats::send<WL_SURFACE_DESTROY>(wl_surface_destroy, m_handle);
         }
     }
 
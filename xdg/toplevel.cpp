@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "../protocol_stats.hpp"
 #include "toplevel.hpp"
 
 namespace fubuki::io::platform::linux_bsd::wayland::xdg
@@ -34,7 +35,7 @@ namespace fubuki::io::platform::linux_bsd::wayland::xdg
 [[nodiscard]]
 auto toplevel::create(surface& parent) noexcept -> std::optional<any_call_info>
 {
-    m_handle = xdg_surface_get_toplevel(parent.xdg_handle());
+    m_handle = protocol_stats::send<XDG_SURFACE_GET_TOPLEVEL>(xdg_surface_get_toplevel, parent.xdg_handle());
 
     if(m_handle == nullptr)
     {
@@ -29,6 +29,7 @@
 #ifndef FUBUKI_IO_PLATFORM_LINUX_WAYLAND_XDG_TOPLEVEL_HPP
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_XDG_TOPLEVEL_HPP
 
+#include "../protocol_stats.hpp"
 #include "surface.hpp"
 
 namespace fubuki::io::platform::linux_bsd::wayland::xdg
@@ -69,7 +70,7 @@ public:
     {
         if(m_handle != nullptr)
         {
-            xdg_toplevel_destroy(m_handle);
+            protocol_stats::send<XDG_TOPLEVEL_DESTROY>(xdg_toplevel_destroy, m_handle);
         }
     }
 
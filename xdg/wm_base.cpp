@@ -30,38 +30,15 @@
 #include "wm_base.hpp"
 
 #include <cassert>
-#include <cstdint>
 #include <iostream>
 
 namespace fubuki::io::platform::linux_bsd::wayland::xdg
 {
 
-namespace
-{
-
-namespace callback
-{
-
-void pong(void* /*user*/, struct xdg_wm_base* handle, std::uint32_t serial) { xdg_wm_base_pong(handle, serial); }
-
-} // namespace callback
-
-namespace listener
-{
-
-constexpr xdg_wm_base_listener xdg = {
-    .ping = callback::pong,
-};
-
-} // namespace listener
-
-} // namespace
-
 [[nodiscard]]
 auto wm_base::create() noexcept -> std::optional<any_call_info>
 {
-    xdg_wm_base_add_listener(m_globals.wm_base, std::addressof(listener::xdg), nullptr);
-
+    // Pings are answered by the display, which binds the global
     if(m_globals.wm_base == nullptr)
     {
         std::cerr << "Parent display globals().wm_base was nullptr\n" << std::flush;
@@ -50,7 +50,13 @@ public:
     {
     };
 
-    wm_base(display& parent) : wm_base{token{}, parent}
+    wm_base(display& parent) : wm_base{parent, parent.globals()} {}
+
+    /**
+     * Constructor. Uses the wm_base of a set of globals, so that surfaces are created on the queue of event_queue::globals for example.
+     * The parent display owns the global and answers its pings: this object never destroys it.
+     */
+    wm_base(display& /*parent*/, const display::global& globals) : wm_base{token{}, globals}
     {
         if(const auto error = create())
         {
@@ -69,17 +75,14 @@ public:
         return *this;
     }
 
-    ~wm_base() noexcept
-    {
-        if(m_handle != nullptr)
-        {
-            xdg_wm_base_destroy(m_handle);
-        }
-    }
+    /// The global belongs to the parent display, and wrappers to their event_queue: nothing to destroy.
+    ~wm_base() noexcept = default;
+
+    [[nodiscard]] static std::expected<wm_base, any_call_info> make(display& parent) noexcept { return make(parent, parent.globals()); }
 
-    [[nodiscard]] static std::expected<wm_base, any_call_info> make(display& parent) noexcept
+    [[nodiscard]] static std::expected<wm_base, any_call_info> make(display& /*parent*/, const display::global& globals) noexcept
     {
-        auto result = wm_base{token{}, parent};
+        auto result = wm_base{token{}, globals};
 
         if(const auto error = result.create())
         {
@@ -104,7 +107,7 @@ public:
 
 private:
 
-    wm_base(token, display& parent) noexcept : m_globals{parent.globals()} {}
+    wm_base(token, const display::global& globals) noexcept : m_globals{globals} {}
 
     [[nodiscard]]
     std::optional<any_call_info> create() noexcept;
@@ -26,13 +26,30 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "../protocol_stats.hpp"
 #include "decoration.hpp"
 
 #include <iostream>
+#include <memory>
 
 namespace fubuki::io::platform::linux_bsd::wayland::zxdg
 {
 
+namespace
+{
+
+namespace listener
+{
+
+// The mode is applied by the toplevel configure that follows, only the event is counted here
+constexpr zxdg_toplevel_decoration_v1_listener decoration = {
+    .configure = protocol_stats::counted<&zxdg_toplevel_decoration_v1_listener::configure>,
+};
+
+} // namespace listener
+
+} // namespace
+
 [[nodiscard]]
 auto decoration::create(xdg::toplevel& parent) noexcept -> std::optional<any_call_info>
 {
@@ -42,13 +59,16 @@ auto decoration::create(xdg::toplevel& parent) noexcept -> std::optional<any_cal
         return any_call_info{};
     }
 
-    m_handle = zxdg_decoration_manager_v1_get_toplevel_decoration(parent.globals().decoration_manager, parent.handle());
+    m_handle = protocol_stats::send<ZXDG_DECORATION_MANAGER_V1_GET_TOPLEVEL_DECORATION>(
+        zxdg_decoration_manager_v1_get_toplevel_decoration, parent.globals().decoration_manager, parent.handle());
 
     if(m_handle == nullptr)
     {
         return any_call_info{};
     }
 
+    zxdg_toplevel_decoration_v1_add_listener(m_handle, std::addressof(listener::decoration), nullptr);
+
     return {};
 }
 
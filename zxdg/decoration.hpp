@@ -30,6 +30,7 @@
 #define FUBUKI_IO_PLATFORM_LINUX_WAYLAND_ZXDG_DECORATION_HPP
 
 #include "../display.hpp"
+#include "../protocol_stats.hpp"
 #include "../xdg/toplevel.hpp"
 #include "generated/decoration-client-protocol.hpp"
 
@@ -86,7 +87,7 @@ public:
     {
         if(m_handle != nullptr)
         {
-            zxdg_toplevel_decoration_v1_destroy(m_handle);
+            protocol_stats::send<ZXDG_TOPLEVEL_DECORATION_V1_DESTROY>(zxdg_toplevel_decoration_v1_destroy, m_handle);
         }
     }
 